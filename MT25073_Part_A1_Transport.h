@@ -0,0 +1,159 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A1_Transport.h
+ * Part: A1 (Two-Copy Implementation)
+ * Description: two_copy_ops: stitches the fields into one buffer, then send().
+ * Shared by server_a1 and the servers that choose a transport at run time.
+ */
+
+#ifndef MT25073_PART_A1_TRANSPORT_H
+#define MT25073_PART_A1_TRANSPORT_H
+
+#include "MT25073_Part_A_Server.h"
+
+// THE "STITCHING" BUFFER (Crucial for Two-Copy)
+// To send the strings as one block using standard send(), we need a single
+// continuous buffer. The payload itself is shared, so the only per-sender
+// memory is this scratch buffer, and it is kept per THREAD, not per
+// connection: an epoll loop serving 1000 clients needs just one.
+typedef struct {
+    char *buf;
+    size_t cap;
+    arena_t arena;                 // Backs buf (NULL base = buf came from malloc)
+    const void *content;           // Payload currently stitched into buf (framed: the connection)
+    unsigned copies;               // ... and how many messages of it, back to back
+    unsigned long first_seq;       // Framed: sequence number in the first header
+} stitch_scratch_t;
+
+pthread_key_t stitch_key;
+pthread_once_t stitch_key_once = PTHREAD_ONCE_INIT;
+
+void stitch_scratch_free(void *arg) {
+    stitch_scratch_t *sc = (stitch_scratch_t *)arg;
+    if (sc->arena.base) arena_destroy(&sc->arena);
+    else free(sc->buf);
+    free(sc);
+}
+
+void stitch_key_create(void) {
+    pthread_key_create(&stitch_key, stitch_scratch_free); // Freed when the thread exits
+}
+
+// The calling thread's scratch buffer, grown to at least `len` bytes.
+stitch_scratch_t *stitch_scratch_get(size_t len) {
+    pthread_once(&stitch_key_once, stitch_key_create);
+    stitch_scratch_t *sc = pthread_getspecific(stitch_key);
+    if (!sc) {
+        sc = calloc(1, sizeof(stitch_scratch_t));
+        if (!sc) return NULL;
+        pthread_setspecific(stitch_key, sc);
+    }
+    if (sc->cap >= len) return sc;
+
+    // Grow. Whatever was stitched is gone, so every connection restitches.
+    if (sc->arena.base) arena_destroy(&sc->arena);
+    else free(sc->buf);
+    sc->content = NULL;
+    create_payload_arena(&sc->arena, len, 1, 1);
+    sc->buf = arena_alloc(&sc->arena, len);
+    if (!sc->buf) sc->buf = malloc(len);
+    sc->cap = sc->buf ? len : 0;
+    return sc->buf ? sc : NULL;
+}
+
+pthread_once_t stitch_report_once = PTHREAD_ONCE_INIT;
+
+void stitch_report(void) {
+    const stitch_kernel_t *kernel = server_config.stitch_kernel;
+    if (!kernel->non_temporal) printf("Stitching: %s for all sizes\n", kernel->name);
+    else printf("Stitching: %s streaming stores from %zu bytes, memcpy below\n",
+                kernel->name, server_config.stitch_threshold);
+}
+
+int two_copy_setup(connection_t *conn) {
+    pthread_once(&stitch_report_once, stitch_report);
+    stitch_scratch_t *sc = stitch_scratch_get(conn->msg_size);
+    if (!sc) {
+        perror("Buffer malloc failed");
+        return -1;
+    }
+    conn->state = sc;
+    return 0;
+}
+
+ssize_t two_copy_send(connection_t *conn, int flags) {
+    stitch_scratch_t *sc = (stitch_scratch_t *)conn->state;
+
+    // Batching (-k): K messages stitched back to back, sent by one send().
+    unsigned batch = conn->max_batch ? conn->max_batch : 1;
+    size_t batch_bytes = batch * conn->msg_size;
+    if (sc->cap < batch_bytes) {
+        sc = stitch_scratch_get(batch_bytes);
+        if (!sc) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    char *linear_buffer = sc->buf;
+
+    // --- COPY #1: USER-SPACE COPY (The "Stitching") ---
+    // This is the inefficiency we are studying.
+    // We loop through our scattered strings and copy them one-by-one into
+    // the linear_buffer. Done at the start of every message; a partial send
+    // resumes from the stitched bytes unless another connection of this
+    // thread stitched a different payload in between.
+    // Large messages are copied with streaming stores (MT25073_Part_A_Stitch.h)
+    // so stitching does not flush the cache; small ones stay with memcpy().
+    // Framed messages differ in their headers, so the buffer is then tied to
+    // the connection; the gap in front of each message is left for its header.
+    const void *content = conn->frame_hdr ? (const void *)conn : (const void *)conn->payload;
+    if (conn->msg_offset == 0 || sc->content != content || sc->copies < batch) {
+        const stitch_kernel_t *kernel = server_config.stitch_kernel;
+        stitch_copy_fn copy = (batch_bytes >= server_config.stitch_threshold)
+                                  ? kernel->copy : stitch_copy_memcpy;
+        size_t offset = 0;
+        for (unsigned m = 0; m < batch; m++) {
+            offset += conn->frame_hdr;
+            for (int i = 0; i < conn->msg.count; i++) {
+                // copy(destination, source, size)
+                copy(linear_buffer + offset, conn->msg.fields[i], conn->msg.sizes[i]);
+
+                // Move the offset forward so the next string is placed right after this one.
+                offset += conn->msg.sizes[i];
+            }
+        }
+        if (copy != stitch_copy_memcpy) stitch_fence();
+        sc->content = content;
+        sc->copies = batch;
+        sc->first_seq = ULONG_MAX;
+    }
+
+    // Headers are written separately: a partial send that completed some
+    // messages of a batch moves the buffer's first message to messages_sent.
+    if (conn->frame_hdr && sc->first_seq != conn->messages_sent) {
+        for (unsigned m = 0; m < batch; m++)
+            memcpy(linear_buffer + m * conn->msg_size,
+                   frame_for(conn, conn->messages_sent + m), conn->frame_hdr);
+        sc->first_seq = conn->messages_sent;
+    }
+
+    // --- COPY #2: KERNEL-SPACE COPY ---
+    // send() copies data from `linear_buffer` (User Land) into the Socket Buffer (Kernel Land).
+    // This is why it's called "Two-Copy": 1. memcpy above, 2. send() here.
+    return conn_send(conn, linear_buffer + conn->msg_offset,
+                     batch_bytes - conn->msg_offset, flags);
+}
+
+void two_copy_teardown(connection_t *conn) {
+    conn->state = NULL; // The scratch buffer belongs to the thread
+}
+
+const transport_ops_t two_copy_ops = {
+    .name = "A1 Two-Copy",
+    .setup = two_copy_setup,
+    .send_message = two_copy_send,
+    .on_error_queue = NULL,
+    .teardown = two_copy_teardown,
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A2_Transport.h
+ * Part: A2 (One-Copy Implementation)
+ * Description: one_copy_ops: sendmsg() with one iovec entry per field, no stitching.
+ * Messages with more than IOV_MAX fields go out in IOV_MAX-entry chunks.
+ * Shared by server_a2 and the servers that choose a transport at run time.
+ */
+
+#ifndef MT25073_PART_A2_TRANSPORT_H
+#define MT25073_PART_A2_TRANSPORT_H
+
+#include "MT25073_Part_A_Server.h"
+
+// Prepare Scatter-Gather Vector (The "One-Copy" Magic)
+// Instead of a malloc'd buffer, we create an array of pointers.
+ssize_t one_copy_send(connection_t *conn, int flags) {
+    struct iovec iov[IOV_MAX];
+    struct msghdr msg_header;
+    int more;
+
+    // Point the vector slots to our existing strings (skipping what a
+    // previous partial sendmsg() already pushed out).
+    memset(&msg_header, 0, sizeof(msg_header));
+    msg_header.msg_iov = iov;
+    // With batching (-k) the vector covers K messages, with framing each
+    // message starts with its header.
+    msg_header.msg_iovlen = build_iov_conn(conn, conn->max_batch ? conn->max_batch : 1,
+                                           iov, IOV_MAX, &more);
+
+    // --- NO MEMCPY LOOP HERE! ---
+    // sendmsg reads the strings directly and sends them. If this is not the
+    // last chunk, MSG_MORE keeps TCP from pushing a short segment in between.
+    return conn_sendmsg(conn, &msg_header, flags | (more ? MSG_MORE : 0));
+}
+
+const transport_ops_t one_copy_ops = {
+    .name = "A2 One-Copy",
+    .setup = NULL,
+    .send_message = one_copy_send,
+    .on_error_queue = NULL,
+    .teardown = NULL,
+};
+
+#endif
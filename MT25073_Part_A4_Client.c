@@ -0,0 +1,13 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A4_Client.c
+ * Part: A4 (io_uring Implementation)
+ * Description: Multithreaded Client (Load Generator).
+ * Spawns multiple threads to connect to the server and measure throughput.
+ */
+
+#include "MT25073_Part_A_Client.h"
+
+int main(int argc, char const *argv[]) {
+    return run_client(argc, argv);
+}
@@ -0,0 +1,17 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A4_Server.c
+ * Part: A4 (io_uring Implementation)
+ * Description: Submits the fields of every message as linked SQEs on an
+ * io_uring. The fields are registered (fixed) buffers, several messages are
+ * batched per io_uring_enter(), and IORING_OP_SEND_ZC is used when the
+ * kernel supports it. Zero-copy notifications come back on the completion
+ * ring instead of MSG_ERRQUEUE, so there is no extra recvmsg() per send.
+ * The transport itself lives in MT25073_Part_A4_Transport.h.
+ */
+
+#include "MT25073_Part_A4_Transport.h"
+
+int main(int argc, char *argv[]) {
+    return run_server(argc, argv, &uring_ops);
+}
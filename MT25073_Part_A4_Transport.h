@@ -0,0 +1,301 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A4_Transport.h
+ * Part: A4 (io_uring Implementation)
+ * Description: uring_ops: linked SQEs over registered buffers, SEND_ZC when
+ * available. Shared by server_a4 and the unified server.
+ */
+
+#ifndef MT25073_PART_A4_TRANSPORT_H
+#define MT25073_PART_A4_TRANSPORT_H
+
+#include "MT25073_Part_A_Server.h"
+#include "MT25073_Part_A_Uring.h"
+
+#define URING_BATCH_MSGS   8      // Messages per io_uring_enter()
+#define URING_MIN_SQ       64     // One SQE per field: 8 fields x 8 messages
+#define URING_MAX_SQ       4096   // Many-field messages span several enters
+#define URING_MAX_FIXED    16384  // Kernel limit on registered buffers
+#define URING_DRAIN_WAIT_MS 2000  // Max wait for SEND_ZC notifications at teardown
+
+// IORING_SEND_ZC_REPORT_USAGE needs kernel 6.2, SEND_ZC itself only 6.0:
+// cleared the first time a send is refused with EINVAL, for every later one.
+int uring_zc_report_usage = 1;
+
+typedef struct {
+    uring_t ring;
+    unsigned sq_entries;             // SQEs per batch: fields x messages, clamped
+    unsigned long max_notifs;        // Outstanding notifications before we wait
+    int use_zc;                      // IORING_OP_SEND_ZC available
+    int report_usage;                // ... with IORING_SEND_ZC_REPORT_USAGE
+    int use_fixed;                   // Fields registered as fixed buffers
+    size_t *expected;                // [sq_entries]
+    int *results;                    // [sq_entries]
+    unsigned long notifs_pending;    // ZC sends whose buffers the kernel still holds
+    unsigned long zc_sends;
+    unsigned long zc_copied;         // Notifications flagged IORING_NOTIF_USAGE_ZC_COPIED
+} uring_state_t;
+
+// --- Helper: consume one CQE (either a send result or a ZC notification) ---
+// Returns 1 if it was a send result, 0 for a notification.
+int uring_reap_one(uring_state_t *st, struct io_uring_cqe *cqe) {
+    if (cqe->flags & IORING_CQE_F_NOTIF) {
+        // The kernel is done with the pages of this send. A SEND_ZC refused
+        // at prep (the REPORT_USAGE fallback below) may post one without
+        // having announced it: never count below zero.
+        if (st->notifs_pending > 0) st->notifs_pending--;
+        metrics_add(METRIC_ZC_DONE, 1);
+        if ((unsigned)cqe->res & IORING_NOTIF_USAGE_ZC_COPIED) {
+            st->zc_copied++;
+            metrics_add(METRIC_ZC_COPIED, 1);
+        }
+        return 0;
+    }
+    st->results[cqe->user_data] = cqe->res;
+    if (cqe->flags & IORING_CQE_F_MORE) {
+        st->notifs_pending++; // A notification CQE will follow
+        st->zc_sends++;
+    }
+    return 1;
+}
+
+// --- Helper: block until at most `limit` notifications are outstanding ---
+// deadline_ns (CLOCK_MONOTONIC, 0 = none) bounds the wait; -1 if it passed.
+int uring_wait_notifs(uring_state_t *st, unsigned long limit, uint64_t deadline_ns) {
+    while (st->notifs_pending > limit) {
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&st->ring)) != NULL) {
+            uring_reap_one(st, cqe);
+            uring_cqe_seen(&st->ring);
+        }
+        if (st->notifs_pending <= limit) break;
+        if (!deadline_ns) {
+            if (uring_submit_and_wait(&st->ring, 1) < 0) return -1;
+            continue;
+        }
+        uint64_t now = run_now_ns();
+        if (now >= deadline_ns) return -1;
+        if (uring_wait_timeout(&st->ring, (unsigned)((deadline_ns - now) / 1000000) + 1) < 0 &&
+            errno != ETIME && errno != EINTR)
+            return -1;
+    }
+    return 0;
+}
+
+void uring_state_free(uring_state_t *st) {
+    free(st->expected);
+    free(st->results);
+    free(st);
+}
+
+int uring_setup(connection_t *conn) {
+    if (conn->ipc == IPC_PIPE) {
+        fprintf(stderr, "A4 io_uring sends need a socket; use -i unix instead of a pipe\n");
+        return -1;
+    }
+    uring_state_t *st = calloc(1, sizeof(uring_state_t));
+    if (!st) return -1;
+
+    // Room for a batch of whole messages, as a power of two
+    // (-k raises the batch; -k auto may go up to BATCH_MAX).
+    unsigned msgs = URING_BATCH_MSGS;
+    if (server_config.batching && server_config.batch_mode == BATCH_COALESCE)
+        msgs = server_config.batch == BATCH_AUTO ? BATCH_MAX : server_config.batch;
+    if (msgs < URING_BATCH_MSGS) msgs = URING_BATCH_MSGS;
+    // Framed messages take one more SQE for the header. With at most
+    // 5 * sq_entries notifications pending (max_notifs + one batch) and >= 2
+    // per framed message, fewer than 10 * msgs <= 2560 messages hold a header:
+    // inside FRAME_RING.
+    unsigned per_msg = (unsigned)conn->msg.count + (conn->frame_hdr ? 1 : 0);
+    unsigned want = per_msg * msgs;
+    st->sq_entries = URING_MIN_SQ;
+    while (st->sq_entries < want && st->sq_entries < URING_MAX_SQ) st->sq_entries *= 2;
+    unsigned cq_entries = 8 * st->sq_entries;  // Results + zero-copy notifications
+    st->max_notifs = cq_entries / 2;
+    st->expected = calloc(st->sq_entries, sizeof(size_t));
+    st->results = calloc(st->sq_entries, sizeof(int));
+    if (!st->expected || !st->results) {
+        uring_state_free(st);
+        return -1;
+    }
+
+    if (uring_init(&st->ring, st->sq_entries, cq_entries) < 0) {
+        perror("io_uring_setup");
+        uring_state_free(st);
+        return -1;
+    }
+
+    // Zero-copy send needs kernel >= 6.0 and TCP; otherwise fall back to WRITE_FIXED / SEND.
+    st->use_zc = conn->ipc == IPC_TCP && uring_opcode_supported(&st->ring, IORING_OP_SEND_ZC);
+    st->report_usage = __atomic_load_n(&uring_zc_report_usage, __ATOMIC_RELAXED);
+
+    // Register the fields as fixed buffers: the kernel pins them once
+    // instead of on every send.
+    if (conn->msg.count <= URING_MAX_FIXED) {
+        struct iovec *iov = calloc(conn->msg.count, sizeof(struct iovec));
+        for (int i = 0; iov && i < conn->msg.count; i++) {
+            iov[i].iov_base = conn->msg.fields[i];
+            iov[i].iov_len = conn->msg.sizes[i];
+        }
+        st->use_fixed = iov && uring_register_buffers(&st->ring, iov, conn->msg.count) == 0;
+        if (!st->use_fixed) perror("io_uring_register buffers (continuing without)");
+        free(iov);
+    }
+
+    printf("[Thread %ld] A4 io_uring: %s, %s buffers\n", pthread_self(),
+           st->use_zc ? "SEND_ZC" : (st->use_fixed ? "WRITE_FIXED" : "SEND"),
+           st->use_fixed ? "fixed" : "regular");
+
+    conn->state = st;
+    return 0;
+}
+
+// Queue one SQE for [buf, buf+len) of field `index` (-1: not a registered
+// buffer, e.g. a frame header).
+void uring_prep_field(uring_state_t *st, struct io_uring_sqe *sqe, int sock,
+                      char *buf, size_t len, int index, int flags) {
+    int fixed = st->use_fixed && index >= 0;
+    if (st->use_zc) {
+        sqe->opcode = IORING_OP_SEND_ZC;
+        sqe->ioprio = st->report_usage ? IORING_SEND_ZC_REPORT_USAGE : 0;
+        if (fixed) {
+            sqe->ioprio |= IORING_RECVSEND_FIXED_BUF;
+            sqe->buf_index = index;
+        }
+    } else if (fixed) {
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->buf_index = index;
+    } else {
+        sqe->opcode = IORING_OP_SEND;
+    }
+    sqe->fd = sock;
+    sqe->addr = (unsigned long)buf;
+    sqe->len = len;
+    // MSG_WAITALL makes io_uring retry short sends internally, so a
+    // link only breaks on a real error.
+    if (sqe->opcode != IORING_OP_WRITE_FIXED) sqe->msg_flags = flags | MSG_WAITALL;
+}
+
+ssize_t uring_send(connection_t *conn, int flags) {
+    uring_state_t *st = (uring_state_t *)conn->state;
+
+    // Bound the pages the kernel holds on our behalf.
+    if (uring_wait_notifs(st, st->max_notifs, 0) < 0) return -1;
+
+    // 1. BUILD THE BATCH: the rest of the current message, then whole messages.
+    // All SQEs are linked so the fields hit the socket strictly in order.
+    unsigned count = 0;
+    size_t offset = conn->msg_offset;
+    struct io_uring_sqe *sqe, *last = NULL;
+    // -k K / auto (or 1 for ping-pong replies) when set; the SQ ring was
+    // sized for it, and the loop stops once the ring is full.
+    unsigned batch = conn->max_batch ? conn->max_batch : URING_BATCH_MSGS;
+    for (unsigned m = 0; m < batch && count < st->sq_entries; m++) {
+        // Framed: the header goes first, from the connection's header ring.
+        if (conn->frame_hdr && offset < conn->frame_hdr) {
+            sqe = uring_get_sqe(&st->ring);
+            if (!sqe) break;
+            char *hdr = (char *)frame_for(conn, conn->messages_sent + m);
+            uring_prep_field(st, sqe, conn->sock, hdr + offset, conn->frame_hdr - offset, -1, flags);
+            sqe->flags = IOSQE_IO_LINK;
+            sqe->user_data = count;
+            last = sqe;
+            st->expected[count] = conn->frame_hdr - offset;
+            st->results[count] = 0;
+            offset = 0;
+            count++;
+        } else {
+            offset -= conn->frame_hdr;
+        }
+        for (int i = 0; i < conn->msg.count; i++) {
+            if (offset >= conn->msg.sizes[i]) {
+                offset -= conn->msg.sizes[i];
+                continue;
+            }
+            sqe = uring_get_sqe(&st->ring);
+            if (!sqe) break;
+            uring_prep_field(st, sqe, conn->sock, conn->msg.fields[i] + offset,
+                             conn->msg.sizes[i] - offset, i, flags);
+            sqe->flags = IOSQE_IO_LINK;
+            sqe->user_data = count;
+            last = sqe;
+            st->expected[count] = conn->msg.sizes[i] - offset;
+            st->results[count] = 0;
+            offset = 0;
+            count++;
+        }
+    }
+    if (count == 0) return 0;
+    last->flags &= ~IOSQE_IO_LINK; // End of the chain
+
+    // 2. SUBMIT EVERYTHING WITH ONE SYSCALL, THEN REAP THE RESULTS
+    unsigned done = 0;
+    int wait_nr = count;
+    while (done < count) {
+        if (uring_submit_and_wait(&st->ring, wait_nr) < 0) return -1;
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&st->ring)) != NULL) {
+            done += uring_reap_one(st, cqe);
+            uring_cqe_seen(&st->ring);
+        }
+        wait_nr = 1;
+    }
+
+    // 3. ONLY THE IN-ORDER PREFIX COUNTS
+    // A short write or error breaks the link; everything after it was cancelled.
+    size_t total = 0;
+    for (unsigned k = 0; k < count; k++) {
+        if (st->results[k] < 0) {
+            if (total == 0 && st->results[k] == -EINVAL && st->use_zc && st->report_usage) {
+                // A 6.0/6.1 kernel: SEND_ZC, but no usage reports. Nothing
+                // was sent (the chain broke at its head); send again without.
+                printf("[Thread %ld] A4 io_uring: no IORING_SEND_ZC_REPORT_USAGE, "
+                       "kernel copies go uncounted\n", pthread_self());
+                st->report_usage = 0;
+                __atomic_store_n(&uring_zc_report_usage, 0, __ATOMIC_RELAXED);
+                return uring_send(conn, flags);
+            }
+            if (total == 0) {
+                errno = -st->results[k];
+                return -1;
+            }
+            break;
+        }
+        total += st->results[k];
+        if ((size_t)st->results[k] != st->expected[k]) break;
+    }
+    return total;
+}
+
+void uring_teardown(connection_t *conn) {
+    uring_state_t *st = (uring_state_t *)conn->state;
+    if (!st) return;
+
+    // Our payload reference goes next: give the kernel a bounded time to
+    // release the pages. A client that stopped reading would otherwise hold
+    // this thread forever; sends still unfinished after that keep their
+    // pages pinned by the kernel itself, so dropping the reference is safe.
+    uring_wait_notifs(st, 0, run_now_ns() + URING_DRAIN_WAIT_MS * 1000000ULL);
+    if (st->use_zc) {
+        if (st->report_usage)
+            printf("[Thread %ld] A4 zero-copy sends=%lu, copied by kernel=%lu, unfinished=%lu\n",
+                   pthread_self(), st->zc_sends, st->zc_copied, st->notifs_pending);
+        else
+            printf("[Thread %ld] A4 zero-copy sends=%lu, copied by kernel=unknown, unfinished=%lu\n",
+                   pthread_self(), st->zc_sends, st->notifs_pending);
+    }
+    uring_exit(&st->ring);
+    uring_state_free(st);
+    conn->state = NULL;
+}
+
+const transport_ops_t uring_ops = {
+    .name = "A4 io_uring",
+    .setup = uring_setup,
+    .send_message = uring_send,
+    .on_error_queue = NULL,
+    .teardown = uring_teardown,
+    .blocking_only = 1,   // Waits on its own completion ring
+};
+
+#endif
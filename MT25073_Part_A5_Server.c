@@ -0,0 +1,18 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A5_Server.c
+ * Part: A5 (sendfile / splice Implementation)
+ * Description: Places the fields in a memfd (page-cache resident, like a
+ * file a real service would serve) and lets the kernel move them to the
+ * socket without user-space iovecs.
+ *   -m sendfile : sendfile(memfd -> socket)                      (default)
+ *   -m splice   : splice(memfd -> pipe), splice(pipe -> socket)
+ *   -m vmsplice : vmsplice(user fields -> pipe), splice(pipe -> socket)
+ * The transport itself lives in MT25073_Part_A5_Transport.h.
+ */
+
+#include "MT25073_Part_A5_Transport.h"
+
+int main(int argc, char *argv[]) {
+    return run_server(argc, argv, &kfile_ops);
+}
@@ -0,0 +1,168 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A5_Transport.h
+ * Part: A5 (sendfile / splice Implementation)
+ * Description: kfile_ops: memfd-resident message sent with sendfile(),
+ * splice() or vmsplice(). Shared by server_a5 and the unified server.
+ */
+
+#ifndef MT25073_PART_A5_TRANSPORT_H
+#define MT25073_PART_A5_TRANSPORT_H
+
+#include "MT25073_Part_A_Server.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+
+#define KFILE_SENDFILE 0
+#define KFILE_SPLICE   1
+#define KFILE_VMSPLICE 2
+
+typedef struct {
+    int mode;
+    int memfd;           // The payload's shared memfd (owned by the payload cache)
+    int pipe_fd[2];      // splice/vmsplice staging pipe
+    size_t pipe_size;    // Capacity of the pipe
+    size_t pipe_bytes;   // Bytes of the current message sitting in the pipe
+} kfile_state_t;
+
+int kfile_mode(const char *variant) {
+    if (!variant || strcmp(variant, "sendfile") == 0) return KFILE_SENDFILE;
+    if (strcmp(variant, "splice") == 0) return KFILE_SPLICE;
+    if (strcmp(variant, "vmsplice") == 0) return KFILE_VMSPLICE;
+    return -1;
+}
+
+int kfile_check_config(const server_config_t *cfg) {
+    if (kfile_mode(cfg->variant) < 0) {
+        fprintf(stderr, "Unknown A5 variant '%s' (sendfile | splice | vmsplice)\n", cfg->variant);
+        return -1;
+    }
+    return 0;
+}
+
+const char *kfile_mode_name(int mode) {
+    if (mode == KFILE_SPLICE) return "splice";
+    if (mode == KFILE_VMSPLICE) return "vmsplice";
+    return "sendfile";
+}
+
+int kfile_setup(connection_t *conn) {
+    kfile_state_t *st = calloc(1, sizeof(kfile_state_t));
+    if (!st) return -1;
+    st->mode = kfile_mode(conn->variant);
+    st->pipe_fd[0] = st->pipe_fd[1] = -1;
+
+    // 1. THE FIELDS IN A MEMFD (once per cached payload, shared by its connections)
+    // The data lives in the page cache just like a cached file. vmsplice maps
+    // the fields themselves and needs no file.
+    st->memfd = -1;
+    if (st->mode != KFILE_VMSPLICE) {
+        st->memfd = payload_memfd(conn->payload);
+        if (st->memfd < 0) {
+            free(st);
+            return -1;
+        }
+    }
+
+    // 2. STAGING PIPE for the splice variants
+    if (st->mode != KFILE_SENDFILE) {
+        if (pipe2(st->pipe_fd, O_CLOEXEC) < 0) {
+            perror("pipe2");
+            free(st);
+            return -1;
+        }
+        // Try to fit a whole message in the pipe; the kernel caps this at
+        // /proc/sys/fs/pipe-max-size, so we keep whatever we get.
+        fcntl(st->pipe_fd[1], F_SETPIPE_SZ, (int)conn->msg_size);
+        int sz = fcntl(st->pipe_fd[1], F_GETPIPE_SZ);
+        st->pipe_size = sz > 0 ? (size_t)sz : 65536;
+    }
+
+    printf("[Thread %ld] A5 %s: %zu bytes\n", pthread_self(),
+           kfile_mode_name(st->mode), conn->msg_size - conn->frame_hdr);
+    conn->state = st;
+    return 0;
+}
+
+// Refill the (empty) pipe with the next chunk of the current message.
+ssize_t kfile_fill_pipe(connection_t *conn, kfile_state_t *st) {
+    size_t offset = conn->msg_offset - conn->frame_hdr; // Into the payload
+    size_t want = conn->msg_size - conn->msg_offset;
+    if (want > st->pipe_size) want = st->pipe_size;
+
+    if (st->mode == KFILE_SPLICE) {
+        // File pages are referenced by the pipe, not copied.
+        loff_t off = offset;
+        return splice(st->memfd, &off, st->pipe_fd[1], NULL, want, SPLICE_F_MOVE);
+    }
+
+    // KFILE_VMSPLICE: map the user-space fields into the pipe (IOV_MAX at a time).
+    struct iovec iov[IOV_MAX];
+    int count = build_iov_from_offset(&conn->msg, offset, iov, IOV_MAX, NULL);
+    // Trim the vector to what the pipe can hold
+    size_t left = want;
+    for (int i = 0; i < count; i++) {
+        if (iov[i].iov_len >= left) {
+            iov[i].iov_len = left;
+            count = i + 1;
+            break;
+        }
+        left -= iov[i].iov_len;
+    }
+    return vmsplice(st->pipe_fd[1], iov, count, 0);
+}
+
+ssize_t kfile_send(connection_t *conn, int flags) {
+    kfile_state_t *st = (kfile_state_t *)conn->state;
+
+    // Framed: the file holds the payload only, the header goes out first
+    // with a plain send() (MSG_MORE: the payload follows immediately).
+    if (conn->msg_offset < conn->frame_hdr) {
+        const char *hdr = (const char *)frame_for(conn, conn->messages_sent);
+        return conn_send(conn, hdr + conn->msg_offset, conn->frame_hdr - conn->msg_offset,
+                         flags | MSG_MORE);
+    }
+
+    if (st->mode == KFILE_SENDFILE) {
+        // sendfile() reads straight from the page cache into the socket.
+        off_t off = conn->msg_offset - conn->frame_hdr;
+        return sendfile(conn->sock, st->memfd, &off, conn->msg_size - conn->msg_offset);
+    }
+
+    // Bytes left in the pipe by a partial splice are flushed before reading more.
+    if (st->pipe_bytes == 0) {
+        ssize_t filled = kfile_fill_pipe(conn, st);
+        if (filled <= 0) {
+            if (filled == 0) errno = EIO;
+            return -1;
+        }
+        st->pipe_bytes = filled;
+    }
+
+    unsigned int sflags = SPLICE_F_MOVE;
+    if (flags & MSG_MORE) sflags |= SPLICE_F_MORE;
+    ssize_t sent = splice(st->pipe_fd[0], NULL, conn->sock, NULL, st->pipe_bytes, sflags);
+    if (sent > 0) st->pipe_bytes -= sent;
+    return sent;
+}
+
+void kfile_teardown(connection_t *conn) {
+    kfile_state_t *st = (kfile_state_t *)conn->state;
+    if (!st) return;
+    if (st->pipe_fd[0] >= 0) close(st->pipe_fd[0]);
+    if (st->pipe_fd[1] >= 0) close(st->pipe_fd[1]);
+    free(st);
+    conn->state = NULL;
+}
+
+const transport_ops_t kfile_ops = {
+    .name = "A5 Kernel-File",
+    .setup = kfile_setup,
+    .send_message = kfile_send,
+    .on_error_queue = NULL,
+    .teardown = kfile_teardown,
+    .check_config = kfile_check_config,
+};
+
+#endif
@@ -0,0 +1,20 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A6_Server.c
+ * Part: A6 (Adaptive Implementation)
+ * Description: Chooses between the A1 (stitch + send), A2 (iovec sendmsg)
+ * and A3 (MSG_ZEROCOPY) transports for every message.
+ *   -m static[:T1,T2] : two-copy below T1 bytes, one-copy below T2,
+ *                       zero-copy from T2 up   (default 8192,524288)
+ *   -m online         : measure the CPU cost per byte of each transport on
+ *                       live traffic, use the cheapest, re-measure regularly.
+ *                       Zero-copy is dropped while the kernel keeps
+ *                       falling back to copying (SO_EE_CODE_ZEROCOPY_COPIED).
+ * The transport itself lives in MT25073_Part_A6_Transport.h.
+ */
+
+#include "MT25073_Part_A6_Transport.h"
+
+int main(int argc, char *argv[]) {
+    return run_server(argc, argv, &adaptive_ops);
+}
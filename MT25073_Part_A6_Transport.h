@@ -0,0 +1,263 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A6_Transport.h
+ * Part: A6 (Adaptive Implementation)
+ * Description: adaptive_ops: per-message choice between the A1, A2 and A3
+ * transports. Shared by server_a6 and the unified server.
+ */
+
+#ifndef MT25073_PART_A6_TRANSPORT_H
+#define MT25073_PART_A6_TRANSPORT_H
+
+#include "MT25073_Part_A1_Transport.h"
+#include "MT25073_Part_A2_Transport.h"
+#include "MT25073_Part_A3_Transport.h"
+
+#define ADAPT_TWO_COPY  0
+#define ADAPT_ONE_COPY  1
+#define ADAPT_ZERO_COPY 2
+#define ADAPT_MODES     3
+
+#define ADAPT_DEFAULT_T1        8192      // Below: stitching is cheaper than one iovec per field
+#define ADAPT_DEFAULT_T2        524288    // From here: zero-copy pays for its notifications
+#define ADAPT_PROBE_MSGS        16        // Messages measured per transport when calibrating
+#define ADAPT_REPROBE_BYTES     (256UL * 1024 * 1024) // Traffic between two calibrations
+#define ADAPT_ZC_MIN_SAMPLES    64        // Completions needed before trusting the fallback rate
+#define ADAPT_ZC_MAX_COPIED_PCT 50        // Above: zero-copy is just a slower copy
+
+const transport_ops_t *adapt_transports[ADAPT_MODES] = { &two_copy_ops, &one_copy_ops, &zero_copy_ops };
+const char *adapt_mode_names[ADAPT_MODES] = { "two-copy", "one-copy", "zero-copy" };
+
+// Parsed from the connection's variant (-m, or the unified server's table)
+typedef struct {
+    int online;
+    size_t t1, t2;
+} adapt_config_t;
+
+typedef struct {
+    adapt_config_t cfg;
+    void *sub_state[ADAPT_MODES];      // conn->state of each transport, set up on first use
+    int ready[ADAPT_MODES];
+    int mode;                          // Transport of the message being sent
+    unsigned long cur_msg;             // conn->messages_sent when `mode` was picked
+    unsigned long msgs[ADAPT_MODES];   // Messages sent per transport
+    // Online calibration
+    int probing;                       // Currently measuring transport `mode`
+    unsigned probe_left;               // Messages left to measure for `mode`
+    uint64_t cost_ns[ADAPT_MODES];     // Thread CPU time spent in send calls ...
+    uint64_t cost_bytes[ADAPT_MODES];  // ... for this many bytes
+    size_t next_probe;                 // total_bytes_sent at which to calibrate again
+} adapt_state_t;
+
+// "static", "static:T1,T2" or "online" (NULL = static). Returns -1 if invalid.
+int adapt_parse_variant(const char *v, adapt_config_t *out) {
+    out->online = 0;
+    out->t1 = ADAPT_DEFAULT_T1;
+    out->t2 = ADAPT_DEFAULT_T2;
+    if (!v || strcmp(v, "static") == 0) return 0;
+    if (strcmp(v, "online") == 0) {
+        out->online = 1;
+        return 0;
+    }
+    unsigned long t1, t2;
+    if (sscanf(v, "static:%lu,%lu", &t1, &t2) == 2 && t1 <= t2) {
+        out->t1 = t1;
+        out->t2 = t2;
+        return 0;
+    }
+    return -1;
+}
+
+int adapt_check_config(const server_config_t *cfg) {
+    adapt_config_t parsed;
+    if (adapt_parse_variant(cfg->variant, &parsed) == 0) return 0;
+    fprintf(stderr, "Unknown A6 variant '%s' (static | static:T1,T2 | online)\n", cfg->variant);
+    return -1;
+}
+
+// --- Helper: thread CPU time (user + kernel) in nanoseconds ---
+// Time blocked in send() is not counted, only the work of the copy path.
+uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Run one sub-transport on the connection, with its own state swapped in.
+ssize_t adapt_call_send(connection_t *conn, adapt_state_t *st, int mode, int flags) {
+    conn->state = st->sub_state[mode];
+    ssize_t sent = adapt_transports[mode]->send_message(conn, flags);
+    st->sub_state[mode] = conn->state;
+    conn->state = st;
+    return sent;
+}
+
+int adapt_ensure_ready(connection_t *conn, adapt_state_t *st, int mode) {
+    if (st->ready[mode]) return 0;
+    if (adapt_transports[mode]->setup) {
+        conn->state = NULL;
+        int ret = adapt_transports[mode]->setup(conn);
+        st->sub_state[mode] = conn->state;
+        conn->state = st;
+        if (ret != 0) return -1;
+    }
+    st->ready[mode] = 1;
+    return 0;
+}
+
+// Zero-copy is only worth probing while the kernel actually avoids the copy.
+int adapt_zero_copy_useful(adapt_state_t *st) {
+    zc_state_t *zc = (zc_state_t *)st->sub_state[ADAPT_ZERO_COPY];
+    if (!zc || zc->zc_sends < ADAPT_ZC_MIN_SAMPLES) return 1;
+    return zc->zc_copied * 100 < zc->zc_sends * ADAPT_ZC_MAX_COPIED_PCT;
+}
+
+int adapt_static_mode(const adapt_config_t *cfg, size_t msg_size) {
+    if (msg_size < cfg->t1) return ADAPT_TWO_COPY;
+    if (msg_size < cfg->t2) return ADAPT_ONE_COPY;
+    return ADAPT_ZERO_COPY;
+}
+
+// Cheapest transport measured in the last calibration round.
+int adapt_cheapest_mode(adapt_state_t *st) {
+    int best = ADAPT_ONE_COPY;
+    double best_cost = -1.0;
+    for (int m = 0; m < ADAPT_MODES; m++) {
+        if (st->cost_bytes[m] == 0) continue;
+        if (m == ADAPT_ZERO_COPY && !adapt_zero_copy_useful(st)) continue;
+        double cost = (double)st->cost_ns[m] / (double)st->cost_bytes[m];
+        if (best_cost < 0 || cost < best_cost) {
+            best = m;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+// Next transport to measure after `mode` (-1 = calibration round finished).
+int adapt_next_probe(adapt_state_t *st, int mode) {
+    for (int m = mode + 1; m < ADAPT_MODES; m++) {
+        if (m == ADAPT_ZERO_COPY && !adapt_zero_copy_useful(st)) continue;
+        return m;
+    }
+    return -1;
+}
+
+// Decide the transport of a new message (only at message boundaries, so a
+// partial send always resumes with the transport that started it).
+void adapt_pick_mode(connection_t *conn, adapt_state_t *st) {
+    if (!st->cfg.online) {
+        st->mode = adapt_static_mode(&st->cfg, conn->msg_size);
+        return;
+    }
+
+    if (!st->probing && conn->total_bytes_sent >= st->next_probe) {
+        // Start a calibration round with fresh numbers
+        memset(st->cost_ns, 0, sizeof(st->cost_ns));
+        memset(st->cost_bytes, 0, sizeof(st->cost_bytes));
+        st->probing = 1;
+        st->mode = ADAPT_TWO_COPY;
+        st->probe_left = ADAPT_PROBE_MSGS;
+    }
+    if (!st->probing) return; // Keep the winner of the last round
+
+    if (st->probe_left == 0) {
+        int next = adapt_next_probe(st, st->mode);
+        if (next < 0) {
+            st->probing = 0;
+            st->mode = adapt_cheapest_mode(st);
+            st->next_probe = conn->total_bytes_sent + ADAPT_REPROBE_BYTES;
+            return;
+        }
+        st->mode = next;
+        st->probe_left = ADAPT_PROBE_MSGS;
+    }
+    st->probe_left--;
+}
+
+int adapt_setup(connection_t *conn) {
+    adapt_state_t *st = calloc(1, sizeof(adapt_state_t));
+    if (!st) return -1;
+    if (adapt_parse_variant(conn->variant, &st->cfg) != 0) {
+        free(st);
+        return -1;
+    }
+    st->cur_msg = (unsigned long)-1; // Forces a pick for the first message
+    conn->state = st;
+    return 0;
+}
+
+ssize_t adapt_send(connection_t *conn, int flags) {
+    adapt_state_t *st = (adapt_state_t *)conn->state;
+
+    if (conn->msg_offset == 0 && conn->messages_sent != st->cur_msg) {
+        adapt_pick_mode(conn, st);
+        st->cur_msg = conn->messages_sent;
+        st->msgs[st->mode]++;
+    }
+    if (adapt_ensure_ready(conn, st, st->mode) < 0) return -1;
+
+    if (!st->probing) return adapt_call_send(conn, st, st->mode, flags);
+
+    // Calibrating: charge the CPU time of this call to the transport.
+    uint64_t start = thread_cpu_ns();
+    ssize_t sent = adapt_call_send(conn, st, st->mode, flags);
+    st->cost_ns[st->mode] += thread_cpu_ns() - start;
+    if (sent > 0) st->cost_bytes[st->mode] += sent;
+    return sent;
+}
+
+// Zero-copy completions keep arriving after we switched away from it.
+void adapt_drain(connection_t *conn) {
+    adapt_state_t *st = (adapt_state_t *)conn->state;
+    if (!st->ready[ADAPT_ZERO_COPY]) return;
+    conn->state = st->sub_state[ADAPT_ZERO_COPY];
+    zero_copy_drain(conn);
+    conn->state = st;
+}
+
+unsigned adapt_in_flight(connection_t *conn) {
+    adapt_state_t *st = (adapt_state_t *)conn->state;
+    if (!st || !st->ready[ADAPT_ZERO_COPY]) return 0;
+    conn->state = st->sub_state[ADAPT_ZERO_COPY];
+    unsigned n = zero_copy_in_flight(conn);
+    conn->state = st;
+    return n;
+}
+
+void adapt_teardown(connection_t *conn) {
+    adapt_state_t *st = (adapt_state_t *)conn->state;
+    if (!st) return;
+
+    printf("[Thread %ld] A6 %s: messages two-copy=%lu one-copy=%lu zero-copy=%lu",
+           pthread_self(), st->cfg.online ? "online" : "static",
+           st->msgs[ADAPT_TWO_COPY], st->msgs[ADAPT_ONE_COPY], st->msgs[ADAPT_ZERO_COPY]);
+    if (st->cfg.online) {
+        printf(", last calibration ns/KB:");
+        for (int m = 0; m < ADAPT_MODES; m++) {
+            if (st->cost_bytes[m] == 0) printf(" %s=-", adapt_mode_names[m]);
+            else printf(" %s=%.1f", adapt_mode_names[m], 1024.0 * st->cost_ns[m] / st->cost_bytes[m]);
+        }
+    }
+    printf("\n");
+
+    for (int m = 0; m < ADAPT_MODES; m++) {
+        if (!st->ready[m] || !adapt_transports[m]->teardown) continue;
+        conn->state = st->sub_state[m];
+        adapt_transports[m]->teardown(conn);
+    }
+    free(st);
+    conn->state = NULL;
+}
+
+const transport_ops_t adaptive_ops = {
+    .name = "A6 Adaptive",
+    .setup = adapt_setup,
+    .send_message = adapt_send,
+    .on_error_queue = adapt_drain,
+    .teardown = adapt_teardown,
+    .in_flight = adapt_in_flight,
+    .check_config = adapt_check_config,
+};
+
+#endif
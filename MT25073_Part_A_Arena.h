@@ -0,0 +1,171 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Arena.h
+ * Description: Memory arena for message payloads and stitching buffers.
+ * Instead of one malloc() per field, the fields of a payload (and, separately,
+ * A1's stitching buffer) are carved out of one mmap()ed region that is:
+ *   - backed by huge pages when large enough (MAP_HUGETLB if requested and
+ *     reserved, otherwise transparent huge pages via MADV_HUGEPAGE),
+ *   - bound to the NUMA node of the CPU that set it up (mbind, preferred),
+ *   - pre-faulted, so no page fault happens on the send path,
+ *   - handed out with a configurable alignment (default: one cache line).
+ * Fewer, larger pages mean fewer TLB misses when a 1 MB message is streamed.
+ */
+
+#ifndef MT25073_PART_A_ARENA_H
+#define MT25073_PART_A_ARENA_H
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h> // MPOL_PREFERRED
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 // Linux 5.14
+#endif
+
+#define ARENA_DEFAULT_ALIGN 64                  // One cache line
+#define ARENA_HUGE_PAGE     (2UL * 1024 * 1024)
+#define ARENA_HUGE_MIN      (1UL * 1024 * 1024) // Smaller arenas stay on 4 KB pages
+
+#define ARENA_PAGES_4K  0
+#define ARENA_PAGES_THP 1   // Transparent huge pages (best effort)
+#define ARENA_PAGES_HUGETLB 2
+
+typedef struct {
+    char *base;       // NULL = arena disabled, callers fall back to malloc()
+    size_t size;
+    size_t used;
+    size_t align;
+    int pages;        // ARENA_PAGES_*
+    int node;         // NUMA node it was bound to (-1 unknown)
+} arena_t;
+
+size_t arena_round_up(size_t value, size_t to) {
+    return (value + to - 1) / to * to;
+}
+
+// Map `len` bytes aligned to `align` (trimming the over-mapped ends).
+void *arena_map_aligned(size_t len, size_t align) {
+    size_t map_len = len + align;
+    char *raw = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    char *start = (char *)arena_round_up((uintptr_t)raw, align);
+    if (start > raw) munmap(raw, start - raw);
+    size_t tail = (raw + map_len) - (start + len);
+    if (tail) munmap(start + len, tail);
+    return start;
+}
+
+// NUMA node of the CPU the calling thread runs on (-1 if unknown).
+int arena_current_node(void) {
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return -1;
+    return (int)node;
+}
+
+// Create an arena of at least `capacity` bytes.
+// huge_tlb: try explicitly reserved huge pages (vm.nr_hugepages) first.
+int arena_create(arena_t *arena, size_t capacity, size_t align, int huge_tlb) {
+    memset(arena, 0, sizeof(*arena));
+    arena->align = align ? align : ARENA_DEFAULT_ALIGN;
+    arena->node = -1;
+    int huge = capacity >= ARENA_HUGE_MIN;
+    size_t page = huge ? ARENA_HUGE_PAGE : (size_t)sysconf(_SC_PAGESIZE);
+    arena->size = arena_round_up(capacity, page);
+
+    // 1. MAP: explicit huge pages, else a 2 MB aligned region THP can back
+    if (huge && huge_tlb) {
+        void *p = mmap(NULL, arena->size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            arena->base = p;
+            arena->pages = ARENA_PAGES_HUGETLB;
+        }
+    }
+    if (!arena->base) {
+        arena->base = arena_map_aligned(arena->size, page);
+        if (!arena->base) return -1;
+        if (huge && madvise(arena->base, arena->size, MADV_HUGEPAGE) == 0)
+            arena->pages = ARENA_PAGES_THP;
+    }
+
+    // 2. NUMA: prefer the node of the CPU we run on (the worker serving this
+    // connection). Must happen before the pages are touched.
+    int node = arena_current_node();
+    if (node >= 0 && node < (int)(8 * sizeof(unsigned long))) {
+        unsigned long mask = 1UL << node;
+        if (syscall(SYS_mbind, arena->base, arena->size, MPOL_PREFERRED, &mask,
+                    8 * sizeof(mask), 0) == 0)
+            arena->node = node;
+    }
+
+    // 3. PRE-FAULT every page now instead of on the first send
+    if (madvise(arena->base, arena->size, MADV_POPULATE_WRITE) != 0) {
+        size_t step = (size_t)sysconf(_SC_PAGESIZE);
+        for (size_t off = 0; off < arena->size; off += step)
+            ((volatile char *)arena->base)[off] = 0;
+    }
+    return 0;
+}
+
+// Bump allocation; NULL when the arena is disabled or full.
+void *arena_alloc(arena_t *arena, size_t len) {
+    if (!arena->base) return NULL;
+    size_t start = arena_round_up(arena->used, arena->align);
+    if (start + len > arena->size) return NULL;
+    arena->used = start + len;
+    return arena->base + start;
+}
+
+int arena_owns(const arena_t *arena, const void *p) {
+    return arena->base && (const char *)p >= arena->base &&
+           (const char *)p < arena->base + arena->size;
+}
+
+// Room an arena needs for `count` buffers of `len` bytes each split in `fields` fields.
+size_t arena_capacity_for(size_t len, int fields, int count, size_t align) {
+    return (size_t)count * (len + (size_t)fields * align);
+}
+
+void arena_destroy(arena_t *arena) {
+    if (arena->base) munmap(arena->base, arena->size);
+    arena->base = NULL;
+}
+
+const char *arena_pages_name(int pages) {
+    if (pages == ARENA_PAGES_HUGETLB) return "hugetlb";
+    if (pages == ARENA_PAGES_THP) return "THP";
+    return "4K";
+}
+
+// Free the fields that did not come from the arena (the arena is unmapped as a whole).
+void free_complex_message_arena(ComplexMessage *msg, const arena_t *arena) {
+    if (!msg->fields) return;
+    for (int i = 0; i < msg->count; i++) {
+        if (msg->fields[i] && !arena_owns(arena, msg->fields[i])) free(msg->fields[i]);
+        msg->fields[i] = NULL;
+    }
+    free(msg->fields);
+    free(msg->sizes);
+    msg->fields = NULL;
+    msg->sizes = NULL;
+}
+
+// Same layout and contents as fill_complex_message(), but every field comes
+// from the arena (aligned). Falls back to malloc() if the arena has no room.
+int fill_complex_message_arena(ComplexMessage *msg, size_t total_size, int count, int layout,
+                               arena_t *arena) {
+    if (layout_complex_message(msg, total_size, count, layout) != 0) return -1;
+    for (int i = 0; i < count; i++) {
+        msg->fields[i] = (char *)arena_alloc(arena, msg->sizes[i]);
+        if (!msg->fields[i]) msg->fields[i] = (char *)malloc(msg->sizes[i]);
+        if (!msg->fields[i]) { // Neither the arena nor the heap had room
+            free_complex_message_arena(msg, arena);
+            return -1;
+        }
+        memset(msg->fields[i], 'A' + i % 26, msg->sizes[i]);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Batch.h
+ * Description: Sending K messages per syscall.
+ * At 1 KB every mode is capped by the syscall rate, not by copying: one
+ * send()/sendmsg() per message. With -k K the server coalesces instead:
+ *   coalesce : K messages in ONE call (A1: one stitched buffer of K
+ *              messages, A2/A3: the fields of K messages as one iovec list,
+ *              A4: K messages per io_uring_enter()).
+ *   more     : one message per call, but MSG_MORE on all except every K-th,
+ *              so TCP builds full segments instead of pushing each message.
+ *   cork     : one message per call under TCP_CORK, uncorked every K messages.
+ * -k auto picks K per connection from a latency budget (-L): the first
+ * message of a batch waits for the other K-1, which at the measured rate
+ * takes (K-1) * msg_size / rate. K is the largest value within the budget.
+ * Ping-pong replies and paced (open-loop) streams are never batched.
+ * Included by MT25073_Part_A_Server.h.
+ */
+
+#ifndef MT25073_PART_A_BATCH_H
+#define MT25073_PART_A_BATCH_H
+
+#define BATCH_COALESCE 0
+#define BATCH_MORE     1
+#define BATCH_CORK     2
+#define BATCH_MODE_COUNT 3
+
+#define BATCH_MAX               256       // Largest K (auto or -k)
+#define BATCH_AUTO              0         // server_config.batch: derive K from -L
+#define BATCH_DEFAULT_BUDGET_US 500
+#define BATCH_AUTO_INTERVAL_NS  50000000ULL// Re-evaluate K every 50 ms
+
+const char *batch_mode_names[BATCH_MODE_COUNT] = { "coalesce", "more", "cork" };
+
+int batch_mode_id(const char *name) {
+    for (int i = 0; i < BATCH_MODE_COUNT; i++)
+        if (strcmp(name, batch_mode_names[i]) == 0) return i;
+    return -1;
+}
+
+void batch_set_k(connection_t *conn, unsigned k) {
+    conn->batch_k = k;
+    // Coalescing is done by the transport, the other modes by the engine,
+    // which needs the transport to send exactly one message per call.
+    conn->max_batch = (server_config.batch_mode == BATCH_COALESCE) ? k : 1;
+}
+
+void batch_set_cork(connection_t *conn, int on) {
+    setsockopt(conn->sock, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+}
+
+// After prepare_connection(): K for this connection.
+void batch_start(connection_t *conn) {
+    conn->batch_k = 1;
+    if (!server_config.batching || conn->pattern == PATTERN_PINGPONG || conn->paced) return;
+    batch_set_k(conn, server_config.batch == BATCH_AUTO ? 1 : server_config.batch);
+    conn->batch_window_ns = run_now_ns();
+    conn->batch_window_bytes = 0;
+    if (server_config.batch_mode == BATCH_CORK) batch_set_cork(conn, 1);
+}
+
+// Extra send flags for the next call (BATCH_MORE).
+int batch_send_flags(const connection_t *conn) {
+    if (server_config.batch_mode != BATCH_MORE || conn->batch_k <= 1) return 0;
+    // Hold back everything but the last message of each group of K.
+    return ((conn->messages_sent + 1) % conn->batch_k) != 0 ? MSG_MORE : 0;
+}
+
+// --- K from the latency budget: K - 1 = budget * rate / msg_size ---
+void batch_autotune(connection_t *conn) {
+    uint64_t now = run_now_ns();
+    uint64_t elapsed = now - conn->batch_window_ns;
+    if (elapsed < BATCH_AUTO_INTERVAL_NS) return;
+
+    double rate = (double)(conn->total_bytes_sent - conn->batch_window_bytes) / elapsed; // bytes/ns
+    double k = 1.0 + server_config.batch_budget_us * 1000.0 * rate / conn->msg_size;
+    unsigned next = k >= BATCH_MAX ? BATCH_MAX : (unsigned)k;
+    if (next != conn->batch_k) batch_set_k(conn, next);
+
+    conn->batch_window_ns = now;
+    conn->batch_window_bytes = conn->total_bytes_sent;
+}
+
+// After record_progress(): flush the cork every K messages, retune K.
+void batch_progress(connection_t *conn, unsigned long messages_before) {
+    if (!server_config.batching || conn->pattern == PATTERN_PINGPONG || conn->paced) return;
+    if (server_config.batch_mode == BATCH_CORK &&
+        conn->messages_sent / conn->batch_k != messages_before / conn->batch_k) {
+        batch_set_cork(conn, 0); // Uncorking pushes out what is queued
+        batch_set_cork(conn, 1);
+    }
+    if (server_config.batch == BATCH_AUTO) batch_autotune(conn);
+}
+
+#endif
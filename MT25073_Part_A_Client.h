@@ -0,0 +1,743 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Client.h
+ * Description: Multithreaded Client (Load Generator) shared by all parts.
+ * The receiving side does not depend on how the server sends, so every
+ * MT25073_Part_A*_Client.c just calls run_client().
+ */
+
+#ifndef MT25073_PART_A_CLIENT_H
+#define MT25073_PART_A_CLIENT_H
+
+#include "MT25073_Part_A_Common.h"
+#include <pthread.h>
+#include <getopt.h>
+#include <errno.h>
+#include <signal.h>
+#include <netinet/tcp.h> // TCP_NODELAY
+#include "MT25073_Part_A_Histogram.h"
+#include "MT25073_Part_A_Sink.h"
+#include "MT25073_Part_A_Frame.h"
+#include "MT25073_Part_A_Pace.h"
+#include "MT25073_Part_A_Perf.h"
+
+#define PACE_SEED 0x5eed0000U // + thread id: every connection gets its own poisson schedule
+
+// Client options (set before the positional arguments are read)
+typedef struct {
+    int cpus[MAX_PINNED_CPUS];   // -c: pin thread i to cpus[i % cpu_count]
+    int cpu_count;               // 0 = no pinning
+    int pattern;                 // -p: PATTERN_STREAM / PATTERN_PINGPONG
+    int outstanding;             // -o: ping-pong requests in flight per connection
+    int sink;                    // -s: SINK_RECV / SINK_TRUNC / SINK_SPLICE / SINK_ZEROCOPY
+    int transport;               // -t: TRANSPORT_* requested in the handshake
+    int fields;                  // -f: fields per message (0 = server default, 8)
+    int layout;                  // -f N:layout: FIELDS_UNIFORM / FIELDS_SKEWED
+    int framing;                 // -F: FRAMING_ON asks for per-message headers
+    int frame_crc;               // -F crc: also verify every payload's CRC32C
+    uint32_t rate;               // -r: open loop, messages per second per connection (0 = closed loop)
+    int arrivals;                // -r N:arrivals: ARRIVALS_CONSTANT / ARRIVALS_POISSON
+    int event_loops;             // -e: epoll loop threads sharing the connections (0 = one thread each)
+    int perf;                    // -P: hardware counters of the receiving threads
+    int ipc;                     // -i: IPC_TCP / IPC_UNIX / IPC_PIPE
+    char unix_path[UNIX_PATH_LEN]; // -i unix|pipe: the server's Unix socket
+    tune_t tune;                 // -T: socket profile, applied here and sent to the server
+    int warmup_ms;               // -W: run this long before the measurement window
+    uint64_t run_start_ns;       // Run start, before the first connect (CLOCK_MONOTONIC)
+} client_config_t;
+
+client_config_t client_config;
+
+// Global variable to aggregate total bytes received across all threads
+// We need a mutex to protect this shared counter.
+long long global_total_bytes = 0;
+long long global_window_bytes = 0;  // ... of which inside the measurement window
+long long global_window_good = 0;   // -F: verified payload bytes inside the window
+long long global_mapped_bytes = 0; // Delivered by TCP_ZEROCOPY_RECEIVE page mapping
+frame_verifier_t global_frames;     // -F: results of all threads' verifiers
+perf_sample_t global_perf;          // -P: all receiving threads' counters
+int global_perf_user_only;
+pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// --- Per-connection receive state ---
+// The epoll engine keeps thousands of these in one array per loop thread,
+// and each thread updates only its own. Padding every connection to whole
+// cache lines keeps two connections (of different threads at the ends of
+// their arrays, or the loop's hot fields) from ever sharing a line.
+#define CLIENT_CACHE_LINE 64
+
+typedef struct {
+    int sock;                       // Where the messages arrive: the socket, or the pipe (-i pipe)
+    int ctrl;                       // Where the handshake and requests go (== sock unless piped)
+    int id;                         // Connection number, 0 .. connections-1 (pace seed)
+    int connected;                  // Epoll engine: 0 while the connect() is in progress
+    size_t wire_size;               // msg_size + the frame header when framed
+    long long bytes;                // Received on this connection
+    size_t msg_progress;            // Bytes of the current message received so far
+    uint64_t last_complete;         // Closed-loop stream: when the previous message completed
+    uint64_t handshake_ns;          // When the handshake went out (open-loop time 0)
+    pace_t pace;                    // Open loop: the server's schedule, recomputed
+    uint64_t *sent_at;              // Ping-pong: FIFO of request send times
+    unsigned long head, tail;
+    request_t seq;
+    latency_histogram_t *latency;   // The thread's histogram, shared by its connections
+    frame_verifier_t *frames;       // -F: checks this connection's stream (NULL = off)
+    run_clock_t clock;              // Warmup / measurement window, as agreed with the server
+} __attribute__((aligned(CLIENT_CACHE_LINE))) client_conn_t;
+
+// Structure to pass arguments to each client thread
+typedef struct {
+    client_conn_t conn;             // The thread's one connection
+    size_t msg_size;
+    int duration_ms;
+    int thread_id;
+} client_thread_args_t;
+
+void conn_init(client_conn_t *c, int id, size_t wire_size, latency_histogram_t *latency,
+               frame_verifier_t *frames) {
+    memset(c, 0, sizeof(*c));
+    c->sock = c->ctrl = -1;
+    c->id = id;
+    c->wire_size = wire_size;
+    c->latency = latency;
+    c->frames = frames;
+    if (client_config.rate)
+        pace_init(&c->pace, client_config.rate, client_config.arrivals, PACE_SEED + id);
+}
+
+// -i unix|pipe: a Unix socket connect completes (or fails) at once, so
+// it is always made blocking; a non-blocking socket is switched over after.
+int client_connect_unix(int nonblocking) {
+    struct sockaddr_un addr;
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        perror("Socket creation error");
+        return -1;
+    }
+    unix_address(&addr, client_config.unix_path);
+    tune_apply(sock, &client_config.tune, 0);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("Connection Failed");
+        close(sock);
+        return -1;
+    }
+    if (nonblocking) fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    return sock;
+}
+
+// Socket connecting to the server. Non-blocking sockets return while the
+// connect() is still in progress (EPOLLOUT reports its end).
+int client_connect(int nonblocking) {
+    if (client_config.ipc != IPC_TCP) return client_connect_unix(nonblocking);
+    struct sockaddr_in serv_addr;
+    int sock = socket(AF_INET, SOCK_STREAM | (nonblocking ? SOCK_NONBLOCK : 0), 0);
+    if (sock < 0) {
+        perror("Socket creation error");
+        return -1;
+    }
+
+    memset(&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT);
+
+    // Convert IPv4 and IPv6 addresses from text to binary form
+    if (inet_pton(AF_INET, SERVER_IP, &serv_addr.sin_addr) <= 0) {
+        perror("Invalid address/ Address not supported");
+        close(sock);
+        return -1;
+    }
+
+    // -T: before connect(), so the receive buffer sets the window scale.
+    tune_apply(sock, &client_config.tune, 1);
+
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 &&
+        !(nonblocking && errno == EINPROGRESS)) {
+        perror("Connection Failed");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// -i pipe: after the handshake, hand the server the write end of a fresh
+// pipe; the messages arrive on its read end, which becomes c->sock.
+int client_attach_pipe(client_conn_t *c) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) < 0) {
+        perror("pipe2");
+        return -1;
+    }
+    // Best effort, like a socket buffer: -T rcvbuf=N sizes it
+    int size = (client_config.tune.mask & TUNE_RCVBUF) ? (int)client_config.tune.rcvbuf : SINK_PIPE_SIZE;
+    fcntl(fds[1], F_SETPIPE_SZ, size);
+    int ret = send_fd(c->ctrl, fds[1]);
+    close(fds[1]); // The server has its own copy now
+    if (ret != 0) {
+        perror("Passing the pipe");
+        close(fds[0]);
+        return -1;
+    }
+    if (fcntl(c->ctrl, F_GETFL) & O_NONBLOCK) fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    c->sock = fds[0];
+    return 0;
+}
+
+// Close the connection's socket, and its pipe if it has one.
+void client_close(client_conn_t *c) {
+    if (c->ctrl >= 0 && c->ctrl != c->sock) close(c->ctrl);
+    if (c->sock >= 0) close(c->sock);
+    c->sock = c->ctrl = -1;
+}
+
+// The Handshake (Send Parameters to Server)
+// We send one handshake_t: [Message Size] [Duration] [Pattern] [Outstanding]
+// [Transport] [Fields] [Layout] [Framing] [Arrivals] [IPC] [Rate] [Seed]
+// [Warmup] [Start] [Run start] [Tuning profile]
+int client_handshake(client_conn_t *c, size_t msg_size, int duration_ms) {
+    handshake_t hs;
+    memset(&hs, 0, sizeof(hs));
+    hs.msg_size = msg_size;
+    hs.duration_ms = duration_ms;
+    hs.warmup_ms = client_config.warmup_ms;
+    hs.run_start_ns = client_config.run_start_ns;
+    run_clock_init(&c->clock, client_config.run_start_ns, client_config.warmup_ms, duration_ms);
+    if (c->frames) c->clock.extra = &c->frames->good_bytes; // Goodput over the same window
+    hs.pattern = client_config.pattern;
+    hs.outstanding = client_config.outstanding;
+    hs.transport = client_config.transport;
+    hs.fields = client_config.fields;
+    hs.layout = client_config.layout;
+    hs.framing = client_config.framing;
+    hs.rate = client_config.rate;
+    hs.arrivals = client_config.arrivals;
+    hs.seed = PACE_SEED + c->id;
+    hs.ipc = client_config.ipc;
+    hs.tune = client_config.tune;
+    hs.start_ns = c->handshake_ns = c->last_complete = run_now_ns();
+    // 112 bytes always fit in a fresh socket's send buffer, blocking or not.
+    c->ctrl = c->sock;
+    if (send(c->ctrl, &hs, sizeof(hs), MSG_NOSIGNAL) != sizeof(hs)) {
+        perror("Handshake failed");
+        return -1;
+    }
+    // What the kernel made of -T, on the first connection only (the server
+    // logs every connection's).
+    if (client_config.tune.mask && c->id == 0)
+        tune_report(stdout, "Client ", c->ctrl, client_config.ipc == IPC_TCP, 0);
+    return client_config.ipc == IPC_PIPE ? client_attach_pipe(c) : 0;
+}
+
+// --- Stream: account for `len` received bytes ---
+// Closed loop: latency = gap between consecutive completions, shared by the
+// messages each read completed.
+// Open loop (-r): latency = completion - intended send time of the message.
+// The schedule starts when the handshake was sent (handshake_t.start_ns).
+// Latency is only recorded inside the measurement window.
+void stream_received(client_conn_t *c, const char *data, size_t len) {
+    int measuring = run_tick(&c->clock, c->bytes) == RUN_MEASURE;
+    c->bytes += len;
+    if (c->frames) frame_verify(c->frames, data, len);
+    c->msg_progress += len;
+
+    if (client_config.rate) {
+        uint64_t now = run_now_ns();
+        while (c->msg_progress >= c->wire_size) {
+            // Messages that arrive together were still due at different times.
+            uint64_t intended = c->handshake_ns + pace_next(&c->pace);
+            if (measuring) hist_record(c->latency, now > intended ? now - intended : 0);
+            c->msg_progress -= c->wire_size;
+        }
+        return;
+    }
+
+    // One timestamp per read: the messages it completed share the time
+    // since the previous completion evenly. (Giving it all to the first one
+    // and 0 to the rest would make the percentiles depend on the read size.)
+    if (c->msg_progress >= c->wire_size) {
+        uint64_t now = run_now_ns();
+        uint64_t completed = c->msg_progress / c->wire_size;
+        if (measuring) hist_record_n(c->latency, (now - c->last_complete) / completed, completed);
+        c->msg_progress -= completed * c->wire_size;
+        c->last_complete = now;
+    }
+}
+
+// --- Ping-pong: closed loop with a window of outstanding requests ---
+// Replies come back in request order (one TCP stream), so the send time of
+// the oldest outstanding request gives the round-trip time of each reply.
+int pingpong_send(client_conn_t *c, uint64_t now) {
+    c->sent_at[c->tail++ % client_config.outstanding] = now;
+    if (send(c->ctrl, &c->seq, sizeof(c->seq), MSG_NOSIGNAL) != sizeof(c->seq)) return -1;
+    c->seq++;
+    return 0;
+}
+
+// Fill the window. Returns -1 if the connection failed.
+int pingpong_start(client_conn_t *c) {
+    int one = 1;
+    setsockopt(c->ctrl, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    c->sent_at = (uint64_t *)malloc(client_config.outstanding * sizeof(uint64_t));
+    if (!c->sent_at) return -1;
+    for (int i = 0; i < client_config.outstanding; i++)
+        if (pingpong_send(c, run_now_ns()) != 0) return -1;
+    return 0;
+}
+
+// Account for `len` received bytes; every complete reply issues the next
+// request right away. Returns -1 if the connection failed.
+int pingpong_received(client_conn_t *c, const char *data, size_t len) {
+    int measuring = run_tick(&c->clock, c->bytes) == RUN_MEASURE;
+    c->bytes += len;
+    if (c->frames) frame_verify(c->frames, data, len);
+    c->msg_progress += len;
+    while (c->msg_progress >= c->wire_size) {
+        c->msg_progress -= c->wire_size;
+        uint64_t now = run_now_ns();
+        uint64_t sent_at = c->sent_at[c->head++ % client_config.outstanding];
+        if (measuring) hist_record(c->latency, now - sent_at);
+        if (pingpong_send(c, now) != 0) return -1;
+    }
+    return 0;
+}
+
+// Add one thread's (or one event loop's) results to the global totals.
+void client_totals_add(long long bytes, long long window, long long window_good, long long mapped,
+                       const frame_verifier_t *fv) {
+    pthread_mutex_lock(&stats_mutex);
+    global_total_bytes += bytes;
+    global_window_bytes += window;
+    global_window_good += window_good;
+    global_mapped_bytes += mapped;
+    if (fv) {
+        global_frames.frames += fv->frames;
+        global_frames.bad_seq += fv->bad_seq;
+        global_frames.bad_crc += fv->bad_crc;
+        global_frames.bad_header += fv->bad_header;
+        global_frames.good_bytes += fv->good_bytes;
+        global_frames.crc_ns += fv->crc_ns;
+    }
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+// -P: count the calling thread from here until client_perf_end()
+void client_perf_begin(perf_group_t *g, perf_sample_t *mark) {
+    if (!client_config.perf) return;
+    perf_group_open(g);
+    perf_group_read(g, mark);
+}
+
+void client_perf_end(perf_group_t *g, const perf_sample_t *mark) {
+    if (!client_config.perf) return;
+    perf_sample_t now, mine, zero;
+    perf_group_read(g, &now);
+    memset(&mine, 0, sizeof(mine));
+    memset(&zero, 0, sizeof(zero));
+    perf_sample_add_delta(&mine, mark, &now);
+    pthread_mutex_lock(&stats_mutex);
+    perf_sample_add_delta(&global_perf, &zero, &mine);
+    global_perf_user_only |= g->user_only;
+    pthread_mutex_unlock(&stats_mutex);
+    perf_group_close(g);
+}
+
+// --- The Worker Thread (One Simulated User) ---
+void *client_thread_func(void *arg) {
+    client_thread_args_t *args = (client_thread_args_t *)arg;
+    client_conn_t *c = &args->conn;
+    receive_sink_t sink;                  // How received data is consumed (-s)
+    ssize_t valread;
+
+    // Pin before connecting: with a CPU-steered server (-A) the SYN is
+    // processed on this CPU and lands on the worker pinned to the same one.
+    if (client_config.cpu_count > 0)
+        pin_thread_to_cpu(client_config.cpus[args->thread_id % client_config.cpu_count]);
+
+    // 1. Create Socket and 2. Connect to Server
+    if ((c->sock = client_connect(0)) < 0) return NULL;
+
+    // 3. The Handshake
+    if (client_handshake(c, args->msg_size, args->duration_ms) != 0) {
+        client_close(c);
+        return NULL;
+    }
+
+    // Set up the receive sink (the zerocopy sink maps the connected socket)
+    if (sink_open(&sink, client_config.sink, c->sock, c->wire_size) != 0) {
+        sink_close(&sink);
+        client_close(c);
+        return NULL;
+    }
+
+    // 4. The Sink Loop (Receive Data) until the server closes the connection
+    perf_group_t perf;
+    perf_sample_t perf_mark;
+    client_perf_begin(&perf, &perf_mark);
+    if (client_config.pattern == PATTERN_PINGPONG) {
+        if (pingpong_start(c) == 0) {
+            while ((valread = sink_read(&sink, c->sock, c->wire_size)) > 0)
+                if (pingpong_received(c, sink.buffer, valread) != 0) break;
+        }
+        free(c->sent_at);
+    } else {
+        while ((valread = sink_read(&sink, c->sock, c->wire_size)) > 0)
+            stream_received(c, sink.buffer, valread);
+    }
+    client_perf_end(&perf, &perf_mark);
+
+    // 5. Update Global Stats
+    long long window = run_window_bytes(&c->clock, c->bytes);
+    client_totals_add(c->bytes, window, run_window_extra(&c->clock), sink.bytes_mapped, c->frames);
+
+    sink_close(&sink);
+    client_close(c);
+    return NULL;
+}
+
+#include "MT25073_Part_A_ClientEpoll.h"
+
+void print_client_usage(const char *prog) {
+    printf("Usage: %s [-c <cpu list>] [-p] [-o <outstanding>] [-s <sink>] [-t <transport>] [-f <fields>[:layout]] [-F crc|seq] [-r <rate>[:arrivals]] [-e <loops>] [-P] [-i <ipc>] [-T <profile>] [-W <warmup>] <Message Size (bytes)> <Thread Count> <Duration>\n", prog);
+    printf("  Duration and warmup: seconds (5, 1.5, 2s) or milliseconds (500ms)\n");
+    printf("  -c L  Pin client thread i to the i-th CPU of L (e.g. 0-3)\n");
+    printf("  -p    Ping-pong: send a request, the server replies with one message (RTT latency)\n");
+    printf("  -o N  Ping-pong: N requests in flight per connection (default 1)\n");
+    printf("  -s S  Receive sink: recv (default) | trunc | splice | zerocopy\n");
+    printf("  -t T  Transport for the unified server: two-copy | one-copy | zero-copy | io_uring |\n"
+           "        sendfile | splice | vmsplice | adaptive | adaptive-online\n");
+    printf("  -f N  Fields per message (default %d); :uniform (default) or :skewed sizes\n",
+           MSG_DEFAULT_FIELDS);
+    printf("  -F V  Framed messages (header with sequence number and CRC32C); verify\n"
+           "        crc (headers and checksums) | seq (headers only). Needs -s recv\n");
+    printf("  -r R  Open loop: the server sends R messages/s per connection, :constant (default)\n"
+           "        or :poisson arrivals; latency is measured from each intended send time\n");
+    printf("  -e N  N epoll event-loop threads drive all connections (Thread Count then means\n"
+           "        connections, e.g. 10000); -c pins the loops. Not with -s zerocopy\n");
+    printf("  -P    Count cycles, instructions, L1D/LLC misses and context switches of the\n"
+           "        receiving threads (perf_event_open, no root needed)\n");
+    printf("  -i I  tcp (loopback port %d, default) | unix[:path] (Unix socket, default %s) |\n"
+           "        pipe[:path] (handshake over the Unix socket, messages through a pipe).\n"
+           "        unix and pipe need a server started with -i unix, pipe a blocking engine\n",
+           PORT, UNIX_SOCKET_PATH);
+    printf("  -T P  Socket profile, applied to this end and sent to the server, which applies it\n"
+           "        too and logs the effective values: sndbuf=N rcvbuf=N nodelay=0|1 lowat=N\n"
+           "        busypoll=us preferbusy=0|1 pacing=B/s (K/M/G suffixes), or the presets\n"
+           "        throughput | latency, comma-separated (later settings win)\n");
+    printf("  -W D  Warmup before the measurement window (default 0): connections are set up\n"
+           "        and data flows, but bytes and latencies only count inside the window\n");
+}
+
+// "-r 10000" or "-r 10000:poisson"
+int parse_rate(const char *arg) {
+    char *end;
+    unsigned long rate = strtoul(arg, &end, 10);
+    if (end == arg || rate == 0 || rate > UINT32_MAX) return -1;
+    client_config.rate = (uint32_t)rate;
+    client_config.arrivals = ARRIVALS_CONSTANT;
+    if (*end == ':') client_config.arrivals = arrival_id(end + 1);
+    else if (*end != '\0') return -1;
+    return client_config.arrivals < 0 ? -1 : 0;
+}
+
+// "-f 64" or "-f 64:skewed"
+int parse_fields(const char *arg) {
+    char *end;
+    long n = strtol(arg, &end, 10);
+    if (end == arg || n < 1 || n > MSG_MAX_FIELDS) return -1;
+    client_config.fields = (int)n;
+    client_config.layout = FIELDS_UNIFORM;
+    if (*end == ':') client_config.layout = layout_id(end + 1);
+    else if (*end != '\0') return -1;
+    return client_config.layout < 0 ? -1 : 0;
+}
+
+int run_client(int argc, char const *argv[]) {
+    // Usage: ./client [options] <Message Size> <Thread Count> <Duration>
+    int c;
+    memset(&client_config, 0, sizeof(client_config));
+    client_config.pattern = PATTERN_STREAM;
+    client_config.outstanding = 1;
+    client_config.sink = SINK_RECV;
+    client_config.ipc = IPC_TCP;
+    while ((c = getopt(argc, (char *const *)argv, "c:po:s:t:f:F:r:e:Pi:T:W:h")) != -1) {
+        switch (c) {
+        case 'c':
+            client_config.cpu_count = parse_cpu_list(optarg, client_config.cpus, MAX_PINNED_CPUS);
+            if (client_config.cpu_count <= 0) {
+                fprintf(stderr, "Invalid CPU list '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'p':
+            client_config.pattern = PATTERN_PINGPONG;
+            break;
+        case 'o':
+            client_config.outstanding = atoi(optarg);
+            if (client_config.outstanding <= 0) {
+                fprintf(stderr, "Outstanding requests must be positive\n");
+                return -1;
+            }
+            break;
+        case 's':
+            client_config.sink = sink_mode(optarg);
+            if (client_config.sink < 0) {
+                fprintf(stderr, "Unknown sink '%s' (recv | trunc | splice | zerocopy)\n", optarg);
+                return -1;
+            }
+            break;
+        case 't':
+            client_config.transport = transport_id(optarg);
+            if (client_config.transport < 0) {
+                fprintf(stderr, "Unknown transport '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'f':
+            if (parse_fields(optarg) != 0) {
+                fprintf(stderr, "Invalid field spec '%s' (1-%d[:uniform|:skewed])\n",
+                        optarg, MSG_MAX_FIELDS);
+                return -1;
+            }
+            break;
+        case 'F':
+            if (strcmp(optarg, "crc") != 0 && strcmp(optarg, "seq") != 0) {
+                fprintf(stderr, "Unknown frame check '%s' (crc | seq)\n", optarg);
+                return -1;
+            }
+            client_config.framing = FRAMING_ON;
+            client_config.frame_crc = strcmp(optarg, "crc") == 0;
+            break;
+        case 'r':
+            if (parse_rate(optarg) != 0) {
+                fprintf(stderr, "Invalid rate '%s' (messages/s[:constant|:poisson])\n", optarg);
+                return -1;
+            }
+            break;
+        case 'P':
+            client_config.perf = 1;
+            break;
+        case 'i':
+            client_config.ipc = parse_ipc(optarg, client_config.unix_path);
+            if (client_config.ipc < 0) {
+                fprintf(stderr, "Invalid IPC '%s' (tcp | unix[:path] | pipe[:path])\n", optarg);
+                return -1;
+            }
+            break;
+        case 'T':
+            if (tune_parse(optarg, &client_config.tune) != 0) {
+                fprintf(stderr, "Invalid socket profile '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'W': {
+            long warmup = parse_duration_ms(optarg);
+            if (warmup < 0) {
+                fprintf(stderr, "Invalid warmup '%s' (e.g. 500ms, 1s)\n", optarg);
+                return -1;
+            }
+            client_config.warmup_ms = (int)warmup;
+            break;
+        }
+        case 'e':
+            client_config.event_loops = atoi(optarg);
+            if (client_config.event_loops <= 0) {
+                fprintf(stderr, "Event loop count must be positive\n");
+                return -1;
+            }
+            break;
+        default:
+            print_client_usage(argv[0]);
+            return -1;
+        }
+    }
+    if (argc - optind != 3) {
+        print_client_usage(argv[0]);
+        return -1;
+    }
+    // The verifier reads the received bytes, which only recv() hands us.
+    if (client_config.framing && client_config.sink != SINK_RECV) {
+        fprintf(stderr, "-F needs the recv sink\n");
+        return -1;
+    }
+    if (client_config.rate && client_config.pattern == PATTERN_PINGPONG) {
+        fprintf(stderr, "-r paces the server's stream; it cannot be combined with -p\n");
+        return -1;
+    }
+    // The zerocopy sink maps one socket; the loops share one sink.
+    if (client_config.event_loops && client_config.sink == SINK_ZEROCOPY) {
+        fprintf(stderr, "-e cannot be combined with -s zerocopy\n");
+        return -1;
+    }
+
+    // MSG_TRUNC and TCP_ZEROCOPY_RECEIVE are TCP features.
+    if (client_config.ipc != IPC_TCP &&
+        (client_config.sink == SINK_TRUNC || client_config.sink == SINK_ZEROCOPY)) {
+        fprintf(stderr, "-s %s needs TCP; use recv or splice with -i %s\n",
+                sink_name(client_config.sink), ipc_names[client_config.ipc]);
+        return -1;
+    }
+
+    size_t msg_size = atoi(argv[optind]);
+    int thread_count = atoi(argv[optind + 1]);
+    long duration_ms = parse_duration_ms(argv[optind + 2]);
+    if (duration_ms <= 0) {
+        fprintf(stderr, "Invalid duration '%s' (e.g. 5, 1.5s, 500ms)\n", argv[optind + 2]);
+        return -1;
+    }
+
+    if (client_config.event_loops > 0)
+        printf("Starting Client: %d Connections on %d epoll loops, %zu Bytes/Msg, %ld ms\n",
+               thread_count, client_config.event_loops, msg_size, duration_ms);
+    else
+        printf("Starting Client: %d Threads, %zu Bytes/Msg, %ld ms\n",
+               thread_count, msg_size, duration_ms);
+    if (client_config.warmup_ms)
+        printf("Warmup: %d ms before the measurement window (not counted)\n", client_config.warmup_ms);
+    if (client_config.pattern == PATTERN_PINGPONG)
+        printf("Ping-pong mode: %d outstanding request(s) per connection\n", client_config.outstanding);
+    if (client_config.transport != TRANSPORT_DEFAULT)
+        printf("Transport: %s\n", transport_names[client_config.transport]);
+    if (client_config.ipc != IPC_TCP)
+        printf("IPC: %s via %s\n", ipc_names[client_config.ipc], client_config.unix_path);
+    if (client_config.sink != SINK_RECV)
+        printf("Receive sink: %s\n", sink_name(client_config.sink));
+    if (client_config.fields)
+        printf("Fields: %d (%s)\n", client_config.fields, layout_names[client_config.layout]);
+    const char *crc_impl = "off";
+    if (client_config.frame_crc) crc32c_select(&crc_impl);
+    if (client_config.framing)
+        printf("Framing: %zu-byte headers, checksums %s\n", FRAME_HDR, crc_impl);
+    if (client_config.rate)
+        printf("Open loop: %u msg/s per connection (%s arrivals), latency from intended send time\n",
+               client_config.rate, arrival_names[client_config.arrivals]);
+
+    if (thread_count <= 0) {
+        print_client_usage(argv[0]);
+        return -1;
+    }
+    raise_fd_limit(); // One descriptor per connection
+    signal(SIGPIPE, SIG_IGN);
+
+    size_t wire_size = msg_size + (client_config.framing ? FRAME_HDR : 0);
+    latency_histogram_t *latency = (latency_histogram_t *)malloc(sizeof(latency_histogram_t));
+    hist_init(latency);
+    int failed = 0;
+    long long spread[3];
+
+    // Start the run: the warmup (connect, handshake, first data) begins
+    // now, and the measurement window is fixed from here on both ends.
+    client_config.run_start_ns = run_now_ns();
+
+    if (client_config.event_loops > 0) {
+        failed = run_client_loops(client_config.event_loops, thread_count, msg_size, wire_size,
+                                  (int)duration_ms, latency, spread);
+    } else {
+        pthread_t *threads = (pthread_t *)calloc(thread_count, sizeof(pthread_t));
+        client_thread_args_t *args = (client_thread_args_t *)aligned_alloc(
+            CLIENT_CACHE_LINE, thread_count * sizeof(client_thread_args_t));
+        if (!threads || !args) {
+            perror("Allocating client threads");
+            return -1;
+        }
+
+        // 1. Spawn Threads
+        for (int i = 0; i < thread_count; i++) {
+            args[i].msg_size = msg_size;
+            args[i].duration_ms = (int)duration_ms;
+            args[i].thread_id = i;
+            latency_histogram_t *thread_latency =
+                (latency_histogram_t *)malloc(sizeof(latency_histogram_t)); // Owned by this thread only
+            hist_init(thread_latency);
+            frame_verifier_t *frames = NULL;
+            if (client_config.framing) {
+                frames = (frame_verifier_t *)malloc(sizeof(frame_verifier_t));
+                frame_verifier_init(frames, msg_size, client_config.frame_crc);
+            }
+            conn_init(&args[i].conn, i, wire_size, thread_latency, frames);
+
+            if (pthread_create(&threads[i], NULL, client_thread_func, (void *)&args[i]) != 0) {
+                perror("Failed to create thread");
+                args[i].thread_id = -1;
+            }
+        }
+
+        // 2. Wait for All Threads to Finish, then merge their histograms
+        for (int i = 0; i < thread_count; i++) {
+            if (args[i].thread_id >= 0) pthread_join(threads[i], NULL);
+            hist_merge(latency, args[i].conn.latency);
+            free(args[i].conn.latency);
+            free(args[i].conn.frames);
+        }
+        free(threads);
+        free(args);
+    }
+
+    // Wall time of the whole run, setup and teardown included
+    double run_time = (run_now_ns() - client_config.run_start_ns) / 1e9;
+
+    // 3. Calculate Metrics over the measurement window only: its bytes,
+    // divided by its exact length (the same on server and client).
+    double time_taken = duration_ms / 1e3;
+    double throughput_bps = (global_window_bytes * 8) / time_taken; // bits per second
+    double throughput_gbps = throughput_bps / 1e9; // Gbps
+
+    printf("------------------------------------------------\n");
+    printf("Test Complete.\n");
+    printf("Total Bytes Received: %lld bytes\n", global_window_bytes);
+    printf("Time Taken:           %.4f seconds\n", time_taken);
+    printf("Throughput:           %.4f Gbps\n", throughput_gbps);
+    printf("Run Time:             %.4f seconds wall, %lld bytes outside the window excluded\n",
+           run_time, global_total_bytes - global_window_bytes);
+    printf("Messages Received:    %llu\n", (unsigned long long)latency->total);
+    if (client_config.perf) {
+        // Cost of receiving: cycles per byte, misses per KB
+        perf_sample_print(stdout, "Client ", &global_perf, global_total_bytes, global_perf_user_only);
+    }
+    if (client_config.event_loops > 0) {
+        // How evenly the server shared itself between the connections
+        printf("Connections:          %d on %d epoll loops, %d failed\n", thread_count,
+               client_config.event_loops, failed);
+        printf("Per-Connection Bytes: min=%lld median=%lld max=%lld\n",
+               spread[0], spread[1], spread[2]);
+    }
+    if (client_config.rate) {
+        // Below the target means the server (or network) could not keep up.
+        printf("Message Rate:         %.1f msg/s (target %.1f)\n", latency->total / time_taken,
+               (double)client_config.rate * thread_count);
+    }
+    if (client_config.sink == SINK_ZEROCOPY) {
+        double pct = global_total_bytes ? 100.0 * global_mapped_bytes / global_total_bytes : 0.0;
+        printf("Mapped (zero-copy):   %lld bytes (%.1f%%)\n", global_mapped_bytes, pct);
+    }
+    if (client_config.framing) {
+        // Goodput = payload bytes of frames that passed every check, i.e.
+        // without the headers and without anything that arrived damaged,
+        // counted and divided over the measurement window like Throughput.
+        printf("Frames Verified:      %lu (sequence gaps %lu, CRC errors %lu, bad headers %lu)\n",
+               global_frames.frames, global_frames.bad_seq, global_frames.bad_crc,
+               global_frames.bad_header);
+        printf("Goodput:              %.4f Gbps\n", global_window_good * 8 / time_taken / 1e9);
+        if (client_config.frame_crc && global_frames.crc_ns > 0) {
+            // Cost of integrity checking: checksum speed, and the share of the
+            // receiving threads' time it took (whole run: the verifier
+            // checks the warmup too).
+            double crc_s = global_frames.crc_ns / 1e9;
+            int receivers = client_config.event_loops ? client_config.event_loops : thread_count;
+            printf("Checksum (%s):    %.2f GB/s, %.1f%% of receive time\n", crc_impl,
+                   global_frames.good_bytes / crc_s / 1e9,
+                   100.0 * crc_s / (run_time * receivers));
+        }
+    }
+    if (client_config.pattern == PATTERN_PINGPONG) {
+        // Request sent -> full reply received
+        hist_print("RTT Latency:         ", latency);
+    } else {
+        // Gap between consecutive complete messages on a connection
+        hist_print("Msg Latency:         ", latency);
+    }
+    printf("------------------------------------------------\n");
+
+    free(latency);
+    return 0;
+}
+
+#endif
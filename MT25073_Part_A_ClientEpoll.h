@@ -0,0 +1,254 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_ClientEpoll.h
+ * Description: Event-driven client engine (client -e N).
+ * One thread per connection caps the load generator at a few hundred
+ * connections, and with more the scheduler, not the server, decides when
+ * data is read. Here N event-loop threads (pinned with -c) each drive their
+ * share of the connections through one epoll instance:
+ *   1. connect() every socket non-blocking; EPOLLOUT reports completion,
+ *      then the handshake goes out (and the ping-pong window is filled).
+ *   2. Level-triggered EPOLLIN: one read per ready connection per round, so
+ *      a busy connection cannot starve the thousands of others.
+ *   3. The server closes the connection when the window ends (read returns 0).
+ * Connections of a loop live in one array of cache-line-padded
+ * client_conn_t; the loop shares one histogram and one sink buffer among them.
+ * Included by MT25073_Part_A_Client.h.
+ */
+
+#ifndef MT25073_PART_A_CLIENT_EPOLL_H
+#define MT25073_PART_A_CLIENT_EPOLL_H
+
+#include <sys/epoll.h>
+
+#define CLIENT_LOOP_EVENTS 256           // epoll_wait() batch
+#define CLIENT_LOOP_READ   (64 * 1024)   // Read up to this much per ready connection
+
+typedef struct {
+    int id;
+    client_conn_t *conns;            // This loop's connections (cache-line aligned)
+    int count;
+    size_t msg_size;
+    int duration_ms;
+    latency_histogram_t *latency;    // Shared by the loop's connections
+    int failed;                      // Connections that never got going
+} __attribute__((aligned(CLIENT_CACHE_LINE))) client_loop_t;
+
+// Connection over (EOF or error): drop it from the loop.
+void client_loop_close(int epfd, client_conn_t *c) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->sock, NULL);
+    if (c->ctrl >= 0 && c->ctrl != c->sock) epoll_ctl(epfd, EPOLL_CTL_DEL, c->ctrl, NULL);
+    client_close(c);
+    free(c->sent_at);
+    c->sent_at = NULL;
+}
+
+// EPOLLOUT on a connecting socket: connected (or refused).
+// Returns 0 once the connection is receiving, -1 if it failed.
+int client_loop_connected(int epfd, client_loop_t *loop, client_conn_t *c) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(c->sock, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0) {
+        fprintf(stderr, "Connection Failed: %s\n", strerror(err));
+        return -1;
+    }
+    c->connected = 1;
+    if (client_handshake(c, loop->msg_size, loop->duration_ms) != 0) return -1;
+    if (client_config.pattern == PATTERN_PINGPONG && pingpong_start(c) != 0) return -1;
+
+    // -i pipe: the messages now arrive on the pipe, not on the socket.
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+    if (c->ctrl != c->sock) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, c->ctrl, NULL);
+        return epoll_ctl(epfd, EPOLL_CTL_ADD, c->sock, &ev);
+    }
+    return epoll_ctl(epfd, EPOLL_CTL_MOD, c->sock, &ev);
+}
+
+void *client_loop_thread(void *arg) {
+    client_loop_t *loop = (client_loop_t *)arg;
+    receive_sink_t sink;
+    struct epoll_event events[CLIENT_LOOP_EVENTS];
+    int active = 0;
+
+    if (client_config.cpu_count > 0)
+        pin_thread_to_cpu(client_config.cpus[loop->id % client_config.cpu_count]);
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1");
+        loop->failed = loop->count;
+        return NULL;
+    }
+
+    // One sink for all connections: each read is consumed before the next.
+    // The zerocopy sink maps a single socket and is refused with -e.
+    size_t read_len = loop->conns[0].wire_size;
+    if (read_len < CLIENT_LOOP_READ) read_len = CLIENT_LOOP_READ;
+    if (sink_open(&sink, client_config.sink, -1, read_len) != 0) {
+        sink_close(&sink);
+        close(epfd);
+        loop->failed = loop->count;
+        return NULL;
+    }
+
+    // Counted from the first connect() to the last EOF
+    perf_group_t perf;
+    perf_sample_t perf_mark;
+    client_perf_begin(&perf, &perf_mark);
+
+    // 1. Start every connect() at once
+    for (int i = 0; i < loop->count; i++) {
+        client_conn_t *c = &loop->conns[i];
+        c->sock = client_connect(1);
+        struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = c };
+        if (c->sock < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, c->sock, &ev) < 0) {
+            if (c->sock >= 0) close(c->sock);
+            c->sock = -1;
+            loop->failed++;
+            continue;
+        }
+        active++;
+    }
+
+    // 2. Serve whichever connections are ready until all are closed
+    while (active > 0) {
+        int n = epoll_wait(epfd, events, CLIENT_LOOP_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            client_conn_t *c = (client_conn_t *)events[i].data.ptr;
+            if (!c->connected) {
+                if (client_loop_connected(epfd, loop, c) != 0) {
+                    loop->failed++;
+                    client_loop_close(epfd, c);
+                    active--;
+                }
+                continue;
+            }
+
+            ssize_t got = sink_read(&sink, c->sock, read_len);
+            if (got < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+            int ok = got > 0;
+            if (ok && client_config.pattern == PATTERN_PINGPONG)
+                ok = pingpong_received(c, sink.buffer, got) == 0;
+            else if (ok)
+                stream_received(c, sink.buffer, got);
+            if (!ok) {
+                // 3. EOF: the server finished this connection
+                client_loop_close(epfd, c);
+                active--;
+            }
+        }
+    }
+
+    client_perf_end(&perf, &perf_mark);
+
+    // Sum the connections, then take the global lock once per loop.
+    long long bytes = 0, window = 0, window_good = 0;
+    frame_verifier_t frames;
+    memset(&frames, 0, sizeof(frames));
+    for (int i = 0; i < loop->count; i++) {
+        client_conn_t *c = &loop->conns[i];
+        if (c->sock >= 0) client_loop_close(epfd, c); // epoll_wait failed
+        bytes += c->bytes;
+        window += run_window_bytes(&c->clock, c->bytes);
+        window_good += run_window_extra(&c->clock);
+        if (c->frames) {
+            frames.frames += c->frames->frames;
+            frames.bad_seq += c->frames->bad_seq;
+            frames.bad_crc += c->frames->bad_crc;
+            frames.bad_header += c->frames->bad_header;
+            frames.good_bytes += c->frames->good_bytes;
+            frames.crc_ns += c->frames->crc_ns;
+        }
+    }
+    client_totals_add(bytes, window, window_good, sink.bytes_mapped, client_config.framing ? &frames : NULL);
+
+    sink_close(&sink);
+    close(epfd);
+    return NULL;
+}
+
+int compare_long_long(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Spread `connections` over `loop_count` event loops and run them to the end.
+// The loops' histograms are merged into `latency`; spread[] gets the min,
+// median and max bytes a connection received. Returns the failed connections.
+int run_client_loops(int loop_count, int connections, size_t msg_size, size_t wire_size,
+                     int duration_ms, latency_histogram_t *latency, long long spread[3]) {
+    client_conn_t *conns = (client_conn_t *)aligned_alloc(CLIENT_CACHE_LINE,
+                                                          connections * sizeof(client_conn_t));
+    client_loop_t *loops = (client_loop_t *)aligned_alloc(CLIENT_CACHE_LINE,
+                                                          loop_count * sizeof(client_loop_t));
+    pthread_t *threads = (pthread_t *)calloc(loop_count, sizeof(pthread_t));
+    if (!conns || !loops || !threads) {
+        perror("Allocating connections");
+        exit(EXIT_FAILURE);
+    }
+    memset(loops, 0, loop_count * sizeof(client_loop_t));
+
+    // Loop i gets a contiguous slice of the connections
+    int first = 0;
+    for (int i = 0; i < loop_count; i++) {
+        client_loop_t *loop = &loops[i];
+        loop->id = i;
+        loop->count = connections / loop_count + (i < connections % loop_count);
+        loop->conns = conns + first;
+        loop->msg_size = msg_size;
+        loop->duration_ms = duration_ms;
+        loop->latency = (latency_histogram_t *)malloc(sizeof(latency_histogram_t));
+        hist_init(loop->latency);
+        for (int j = 0; j < loop->count; j++) {
+            frame_verifier_t *fv = NULL;
+            if (client_config.framing) {
+                fv = (frame_verifier_t *)malloc(sizeof(frame_verifier_t));
+                frame_verifier_init(fv, msg_size, client_config.frame_crc);
+            }
+            conn_init(&loop->conns[j], first + j, wire_size, loop->latency, fv);
+        }
+        first += loop->count;
+    }
+
+    for (int i = 0; i < loop_count; i++) {
+        if (loops[i].count == 0) continue;
+        if (pthread_create(&threads[i], NULL, client_loop_thread, &loops[i]) != 0) {
+            perror("Failed to create event loop");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int failed = 0;
+    for (int i = 0; i < loop_count; i++) {
+        if (loops[i].count > 0) pthread_join(threads[i], NULL);
+        hist_merge(latency, loops[i].latency);
+        failed += loops[i].failed;
+        free(loops[i].latency);
+    }
+
+    // Fairness: how evenly the server shared itself between connections.
+    long long *bytes = (long long *)malloc(connections * sizeof(long long));
+    for (int i = 0; i < connections; i++) {
+        bytes[i] = conns[i].bytes;
+        free(conns[i].frames);
+    }
+    qsort(bytes, connections, sizeof(long long), compare_long_long);
+    spread[0] = bytes[0];
+    spread[1] = bytes[connections / 2];
+    spread[2] = bytes[connections - 1];
+
+    free(bytes);
+    free(threads);
+    free(loops);
+    free(conns);
+    return failed;
+}
+
+#endif
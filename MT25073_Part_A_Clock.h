@@ -0,0 +1,138 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Clock.h
+ * Description: Run control on CLOCK_MONOTONIC, in milliseconds.
+ * A run is a warmup followed by a measurement window, both on the client's
+ * CLOCK_MONOTONIC (which the server shares on the same host):
+ *
+ *   run start            + warmup_ms           + duration_ms
+ *       |---- RUN_WARMUP ----|---- RUN_MEASURE ----|  RUN_DONE
+ *
+ * The client takes the run start once, before it connects anything, and
+ * sends it in every handshake, so connect, handshake and buffer setup fall
+ * into the warmup and every connection of both ends agrees on the same
+ * window. The server stops sending when the window ends; the client counts
+ * only what arrived inside it and divides by its exact length.
+ *
+ * Checking the clock in a send/receive loop that turns every microsecond
+ * would cost a clock read per message. run_tick() reads it only every
+ * `stride` calls and adapts the stride so a real read happens about every
+ * RUN_CHECK_NS: a phase change is seen at most a few of those late.
+ * Shared by the servers and the client.
+ */
+
+#ifndef MT25073_PART_A_CLOCK_H
+#define MT25073_PART_A_CLOCK_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RUN_WARMUP  0
+#define RUN_MEASURE 1
+#define RUN_DONE    2
+
+#define RUN_CHECK_NS    100000ULL      // Target gap between real clock reads (100 us)
+#define RUN_STRIDE_MAX  4096           // Calls per clock read, at most
+#define RUN_MAX_SKEW_NS 10000000000ULL // A start further off than this: not our clock
+
+typedef struct {
+    uint64_t measure_ns;      // Warmup ends, measurement starts
+    uint64_t end_ns;          // Measurement (and the run) ends
+    uint64_t checked_ns;      // Time of the last real clock read
+    uint64_t bytes_at_measure; // Byte count when RUN_MEASURE was first seen
+    uint64_t bytes_at_end;     // ... and when RUN_DONE was
+    const long long *extra;   // Optional second counter, snapshotted at the same instants
+    long long extra_at_measure, extra_at_end; // (client -F: verified payload bytes)
+    uint32_t stride;          // Calls between clock reads
+    uint32_t countdown;       // Calls left until the next read
+    int phase;                // RUN_*, as of the last read
+} run_clock_t;
+
+// --- CLOCK_MONOTONIC in nanoseconds (vDSO, no syscall); the one clock of the tree ---
+uint64_t run_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// "5" or "1.5" (seconds), "2s", "500ms" -> milliseconds. -1 if invalid.
+long parse_duration_ms(const char *text) {
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || v < 0) return -1;
+    if (end[0] == 'm' && end[1] == 's' && end[2] == '\0') v /= 1000;
+    else if (!(end[0] == '\0' || (end[0] == 's' && end[1] == '\0'))) return -1;
+    if (v > 86400.0 * 24) return -1; // Fits an int32 of milliseconds
+    return (long)(v * 1000 + 0.5);
+}
+
+// The server's run start: the client's, when it makes sense on our clock
+// (same host: it lies in the past, within the run), otherwise "now".
+uint64_t run_agreed_start(uint64_t client_start_ns, uint32_t warmup_ms, uint32_t duration_ms) {
+    uint64_t now = run_now_ns();
+    uint64_t span = ((uint64_t)warmup_ms + duration_ms) * 1000000ULL + RUN_MAX_SKEW_NS;
+    return (client_start_ns && client_start_ns <= now && now - client_start_ns < span)
+               ? client_start_ns : now;
+}
+
+void run_clock_init(run_clock_t *rc, uint64_t start_ns, uint32_t warmup_ms, uint32_t duration_ms) {
+    rc->measure_ns = start_ns + (uint64_t)warmup_ms * 1000000ULL;
+    rc->end_ns = rc->measure_ns + (uint64_t)duration_ms * 1000000ULL;
+    rc->checked_ns = start_ns;
+    rc->bytes_at_measure = rc->bytes_at_end = 0;
+    rc->extra = NULL;
+    rc->extra_at_measure = rc->extra_at_end = 0;
+    rc->stride = rc->countdown = 1;
+    rc->phase = RUN_WARMUP;
+}
+
+// Read the clock now. `bytes` is the caller's running byte count,
+// remembered at each phase change.
+int run_check(run_clock_t *rc, uint64_t bytes) {
+    uint64_t now = run_now_ns();
+    int phase = now >= rc->end_ns ? RUN_DONE : now >= rc->measure_ns ? RUN_MEASURE : RUN_WARMUP;
+    if (phase != rc->phase) {
+        long long extra = rc->extra ? *rc->extra : 0;
+        if (rc->phase == RUN_WARMUP) { // Also when the warmup was skipped
+            rc->bytes_at_measure = bytes;
+            rc->extra_at_measure = extra;
+        }
+        if (phase == RUN_DONE) {
+            rc->bytes_at_end = bytes;
+            rc->extra_at_end = extra;
+        }
+        rc->phase = phase;
+    }
+    // Reads closer together than the target: read half as often; further: twice.
+    uint64_t gap = now - rc->checked_ns;
+    if (gap < RUN_CHECK_NS / 2 && rc->stride < RUN_STRIDE_MAX) rc->stride *= 2;
+    else if (gap > RUN_CHECK_NS * 2 && rc->stride > 1) rc->stride /= 2;
+    rc->checked_ns = now;
+    rc->countdown = rc->stride;
+    return phase;
+}
+
+// The hot-loop check: usually just a decrement.
+int run_tick(run_clock_t *rc, uint64_t bytes) {
+    if (--rc->countdown > 0) return rc->phase;
+    return run_check(rc, bytes);
+}
+
+// Bytes counted inside the measurement window. Call once the transfer is
+// over: whatever arrived since the last read is attributed by a final one.
+uint64_t run_window_bytes(run_clock_t *rc, uint64_t bytes) {
+    if (rc->phase != RUN_DONE) run_check(rc, bytes);
+    if (rc->phase == RUN_WARMUP) return 0;
+    uint64_t last = rc->phase == RUN_DONE ? rc->bytes_at_end : bytes;
+    return last - rc->bytes_at_measure;
+}
+
+// The same for the extra counter; after run_window_bytes() (its final read).
+long long run_window_extra(const run_clock_t *rc) {
+    if (!rc->extra || rc->phase == RUN_WARMUP) return 0;
+    long long last = rc->phase == RUN_DONE ? rc->extra_at_end : *rc->extra;
+    return last - rc->extra_at_measure;
+}
+
+#endif
@@ -8,6 +8,10 @@
  #ifndef MT25073_PART_A_COMMON_H
  #define MT25073_PART_A_COMMON_H
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // accept4(), CPU_SET, pthread_setaffinity_np
+#endif
+
  #include <stdio.h>
 #include <stdlib.h> // Standard Library (malloc, free, exit)
 #include <string.h> // String manipulation (memset, memcpy)
@@ -15,41 +19,299 @@
 #include <arpa/inet.h> // Internet definitions (struct sockaddr_in, htons)
 #include <time.h>
 #include <sys/time.h> // System time (gettimeofday for microsecond precision)
+#include <sched.h> // CPU affinity (cpu_set_t)
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/resource.h> // setrlimit (open file limit)
+#include <sys/un.h> // Unix domain sockets (struct sockaddr_un)
+#include "MT25073_Part_A_Tune.h" // tune_t (socket tuning profile in the handshake)
+#include "MT25073_Part_A_Clock.h" // run_clock_t (warmup + measurement window)
 
 #define PORT 8080
 #define SERVER_IP "127.0.0.1"
+#define READY_FD_ENV "MT25073_READY_FD" // Pipe a server reports "listening" on
+
+// --- Local IPC (client -i, server -i) ---
+// Co-located producer and consumer do not need TCP/IP at all. The same copy
+// strategies run over a Unix domain stream socket, or over a pipe: the
+// client connects to the Unix socket, sends the handshake and then the write
+// end of a pipe (SCM_RIGHTS); the server sends the messages into that pipe.
+#define IPC_TCP   0 // TCP over loopback, PORT (default)
+#define IPC_UNIX  1 // Unix domain stream socket
+#define IPC_PIPE  2 // Pipe passed over the Unix socket (blocking server engines)
+#define IPC_COUNT 3
+#define UNIX_SOCKET_PATH "/tmp/MT25073.sock"
+#define UNIX_PATH_LEN 108 // sizeof(((struct sockaddr_un *)0)->sun_path)
+
+const char *ipc_names[IPC_COUNT] = { "tcp", "unix", "pipe" };
+
+// --- Traffic patterns (chosen by the client in the handshake) ---
+#define PATTERN_STREAM   0 // Server pushes messages until the measurement window ends
+#define PATTERN_PINGPONG 1 // Client sends a request, server answers with one message
+
+// The handshake the client sends right after connect().
+// Fixed-width fields so client and server agree on the layout.
+typedef struct {
+    uint64_t msg_size;     // Bytes per ComplexMessage
+    int32_t duration_ms;   // Measurement window, after the warmup
+    int32_t pattern;       // PATTERN_*
+    int32_t outstanding;   // Ping-pong: requests in flight per connection
+    int32_t transport;     // TRANSPORT_*: copy strategy the client wants
+    int32_t fields;        // Fields per message (0 = MSG_DEFAULT_FIELDS)
+    int32_t layout;        // FIELDS_*: how msg_size is split over the fields
+    int32_t framing;       // FRAMING_*: per-message headers (MT25073_Part_A_Frame.h)
+    int32_t arrivals;      // ARRIVALS_*: open-loop schedule (MT25073_Part_A_Pace.h)
+    int32_t ipc;           // IPC_*: IPC_PIPE = the data pipe follows the handshake
+    uint32_t rate;         // Stream: messages per second (0 = as fast as possible)
+    uint32_t seed;         // Seed of the poisson schedule
+    uint32_t warmup_ms;    // Sent, but not measured, before the window
+    uint64_t start_ns;     // Schedule time 0 on the client's CLOCK_MONOTONIC
+    uint64_t run_start_ns; // Run start (warmup begins), same clock (MT25073_Part_A_Clock.h)
+    tune_t tune;           // Socket options the client wants (MT25073_Part_A_Tune.h)
+} handshake_t;
+
+#define FRAMING_OFF 0 // Bare messages, back to back
+#define FRAMING_ON  1 // frame_header_t in front of every message
+
+// --- Message layout (handshake_t.fields / .layout) ---
+#define MSG_DEFAULT_FIELDS 8      // The assignment's 8 strings
+#define MSG_MAX_FIELDS     65536
+#define FIELDS_UNIFORM     0      // Equal fields, the last one takes the remainder
+#define FIELDS_SKEWED      1      // Deterministic pseudo-random sizes (1x .. 64x)
+#define FIELDS_LAYOUT_COUNT 2
+
+const char *layout_names[FIELDS_LAYOUT_COUNT] = { "uniform", "skewed" };
+
+// --- Transports a client can ask for (handshake_t.transport) ---
+// A single-transport server (server_a1 ... server_a6) only accepts
+// TRANSPORT_DEFAULT; the unified server dispatches on all of them.
+#define TRANSPORT_DEFAULT         0 // Whatever the server was started with
+#define TRANSPORT_TWO_COPY        1 // A1: stitch + send()
+#define TRANSPORT_ONE_COPY        2 // A2: sendmsg() with iovec
+#define TRANSPORT_ZERO_COPY       3 // A3: sendmsg() with MSG_ZEROCOPY
+#define TRANSPORT_IO_URING        4 // A4: io_uring
+#define TRANSPORT_SENDFILE        5 // A5 -m sendfile
+#define TRANSPORT_SPLICE          6 // A5 -m splice
+#define TRANSPORT_VMSPLICE        7 // A5 -m vmsplice
+#define TRANSPORT_ADAPTIVE        8 // A6 -m static
+#define TRANSPORT_ADAPTIVE_ONLINE 9 // A6 -m online
+#define TRANSPORT_COUNT           10
+
+const char *transport_names[TRANSPORT_COUNT] = {
+    "default", "two-copy", "one-copy", "zero-copy", "io_uring",
+    "sendfile", "splice", "vmsplice", "adaptive", "adaptive-online",
+};
+
+// Name (as given to the client's -t) -> TRANSPORT_*, or -1
+int transport_id(const char *name) {
+    for (int i = 0; i < TRANSPORT_COUNT; i++)
+        if (strcmp(name, transport_names[i]) == 0) return i;
+    return -1;
+}
+
+// "tcp", "unix[:path]" or "pipe[:path]" -> IPC_*, with the socket path in
+// path[UNIX_PATH_LEN] (UNIX_SOCKET_PATH if none is given). -1 if invalid.
+int parse_ipc(const char *spec, char *path) {
+    const char *colon = strchr(spec, ':');
+    size_t name_len = colon ? (size_t)(colon - spec) : strlen(spec);
+    int ipc = -1;
+    for (int i = 0; i < IPC_COUNT; i++)
+        if (strlen(ipc_names[i]) == name_len && strncmp(spec, ipc_names[i], name_len) == 0) ipc = i;
+    if (ipc < 0 || (colon && (ipc == IPC_TCP || colon[1] == '\0'))) return -1;
+    const char *p = colon ? colon + 1 : UNIX_SOCKET_PATH;
+    if (strlen(p) >= UNIX_PATH_LEN) return -1;
+    strcpy(path, p);
+    return ipc;
+}
+
+// Address of the Unix socket at `path`
+void unix_address(struct sockaddr_un *addr, const char *path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strncpy(addr->sun_path, path, sizeof(addr->sun_path) - 1);
+}
+
+// --- Passing a descriptor over a Unix socket (IPC_PIPE) ---
+// SCM_RIGHTS needs at least one byte of real data to travel with.
+int send_fd(int sock, int fd) {
+    char byte = 'P';
+    struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == 1 ? 0 : -1;
+}
+
+// The descriptor sent by send_fd(), or -1.
+int recv_fd(int sock) {
+    char byte;
+    struct iovec iov = { .iov_base = &byte, .iov_len = 1 };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) != 1) return -1;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) return -1;
+    int fd;
+    memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    return fd;
+}
+
+// Ping-pong request: the client's sequence number, echoed nowhere, only counted.
+typedef uint64_t request_t;
 
 typedef struct{
-char * fields[8]; // array of pointers to  8 strings
-size_t sizes[8]; // keep track of the size of each string
+int count; // number of fields (8 in the assignment, anything from 1 up)
+char ** fields; // array of pointers to the strings
+size_t * sizes; // keep track of the size of each string
 
 }ComplexMessage;
 
+// Name -> FIELDS_*, or -1
+int layout_id(const char *name) {
+    for (int i = 0; i < FIELDS_LAYOUT_COUNT; i++)
+        if (strcmp(name, layout_names[i]) == 0) return i;
+    return -1;
+}
+
+// Split total_size bytes over `count` fields (allocates fields[] and sizes[],
+// not the strings themselves). Every field gets at least one byte, so
+// count must not exceed total_size. Returns -1 on bad arguments or no memory.
+int layout_complex_message(ComplexMessage *msg, size_t total_size, int count, int layout) {
+    if (count <= 0 || (size_t)count > total_size) return -1;
+    msg->count = count;
+    msg->fields = calloc(count, sizeof(char *));
+    msg->sizes = calloc(count, sizeof(size_t));
+    if (!msg->fields || !msg->sizes) {
+        free(msg->fields);
+        free(msg->sizes);
+        return -1;
+    }
+
+    if (layout == FIELDS_SKEWED) {
+        // Weights 1..64 from a fixed LCG: both sides of every run see the same sizes.
+        uint32_t seed = 12345, weight_sum = 0;
+        for (int i = 0; i < count; i++) {
+            seed = seed * 1103515245u + 12345u;
+            msg->sizes[i] = 1 + ((seed >> 16) % 64);
+            weight_sum += msg->sizes[i];
+        }
+        size_t spare = total_size - count, given = 0; // 1 byte each is already reserved
+        for (int i = 0; i < count; i++) {
+            msg->sizes[i] = 1 + spare * msg->sizes[i] / weight_sum;
+            given += msg->sizes[i];
+        }
+        msg->sizes[count - 1] += total_size - given;
+        return 0;
+    }
+
+    size_t chunk_size = total_size / count;
+    for (int i = 0; i < count; i++) msg->sizes[i] = chunk_size;
+    msg->sizes[count - 1] = total_size - (size_t)(count - 1) * chunk_size;
+    return 0;
+}
 
 //Memory cleanup helper
 
 void free_complex_message(ComplexMessage *msg){
-    if(!msg) return; // dont free a null pointer
-    for(int i = 0;i<8;i++){
+    if(!msg || !msg->fields) return; // dont free a null pointer
+    for(int i = 0;i<msg->count;i++){
         if(msg->fields[i]){
             free(msg->fields[i]); // free the actual string data
             msg->fields[i]=NULL; //dangle prevention : memory leak
         }
     }
+    free(msg->fields);
+    free(msg->sizes);
+    msg->fields = NULL;
+    msg->sizes = NULL;
 }
 
-void fill_complex_message(ComplexMessage *msg,size_t total_size){
-    size_t chunk_size = total_size/8;
-    
-    for(int i =0;i<8;i++){
-        if(i==7){
-            chunk_size = total_size - (7*(total_size/8));
+// Field i is filled with 'A' + i (wrapping after 'Z').
+int fill_complex_message(ComplexMessage *msg,size_t total_size,int count,int layout){
+    if(layout_complex_message(msg,total_size,count,layout) != 0) return -1;
+
+    for(int i =0;i<count;i++){
+        msg->fields[i]= (char*)malloc(msg->sizes[i]);
+        if(!msg->fields[i]){ // out of memory: undo the fields so far
+            free_complex_message(msg);
+            return -1;
         }
-        msg->sizes[i] = chunk_size;
-        msg->fields[i]= (char*)malloc(chunk_size);
-        memset(msg->fields[i],'A'+i,chunk_size); //Fills memory
+        memset(msg->fields[i],'A'+i%26,msg->sizes[i]); //Fills memory
     }
+    return 0;
+}
+
+// --- CPU pinning helpers (server workers and client threads) ---
 
+#define MAX_PINNED_CPUS 256
+
+// Parse a CPU list such as "0-3,8,10-11" into cpus[]. Returns the count, -1 on error.
+int parse_cpu_list(const char *list, int *cpus, int max) {
+    int count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p || first < 0) return -1;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return -1;
+        }
+        for (long c = first; c <= last; c++) {
+            if (count >= max) return -1;
+            cpus[count++] = (int)c;
+        }
+        if (*end == ',') end++;
+        else if (*end != '\0') return -1;
+        p = end;
+    }
+    return count;
+}
+
+// Pin the calling thread to one CPU so it is not migrated by the scheduler.
+int pin_thread_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0) {
+        fprintf(stderr, "Could not pin thread to CPU %d: %s\n", cpu, strerror(err));
+        return -1;
+    }
+    return 0;
+}
+
+// Thousands of connections need thousands of descriptors: raise the soft
+// open-file limit to the hard limit (the default soft limit is often 1024).
+void raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,441 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Epoll.h
+ * Description: Event-driven engine for the PA02 servers.
+ * A fixed number of event-loop threads each own an epoll instance. All
+ * client sockets are non-blocking and registered edge-triggered, so one
+ * thread can stream to thousands of clients without a kernel thread each.
+ * Paced (open-loop) connections that are not due yet wait in a per-loop
+ * timer heap; epoll_pwait2() sleeps exactly until the earliest is due.
+ * Included by MT25073_Part_A_Server.h (needs connection_t / transport_ops_t).
+ */
+
+#ifndef MT25073_PART_A_EPOLL_H
+#define MT25073_PART_A_EPOLL_H
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+#define EPOLL_MAX_EVENTS  256
+#define EPOLL_SEND_BUDGET 16   // Messages per connection before yielding to the next one
+#define EPOLL_TICK_MS     10   // Max sleep, so expired windows are noticed without traffic
+#define EPOLL_LINGER_MS   2000 // Max wait for a closed connection's zero-copy completions
+
+typedef struct {
+    int id;
+    int epfd;
+    int listen_fd;
+    int cpu;                                  // -1 = not pinned
+    const transport_ops_t *ops;
+    connection_t *conns;                      // All live connections of this loop
+    connection_t *ready_head, *ready_tail;    // Writable connections with work left
+    connection_t **timers;                    // Paced connections not due yet (min-heap on pace_due_ns)
+    int timer_count, timer_cap;
+} event_loop_t;
+
+// --- Ready queue: connections that can still send without blocking ---
+// Edge-triggered epoll only reports EPOLLOUT on a transition, so a connection
+// that used up its budget before hitting EAGAIN must be remembered here.
+void loop_push_ready(event_loop_t *loop, connection_t *conn) {
+    if (conn->in_ready) return;
+    conn->in_ready = 1;
+    conn->ready_next = NULL;
+    if (loop->ready_tail) loop->ready_tail->ready_next = conn;
+    else loop->ready_head = conn;
+    loop->ready_tail = conn;
+}
+
+connection_t *loop_pop_ready(event_loop_t *loop) {
+    connection_t *conn = loop->ready_head;
+    if (!conn) return NULL;
+    loop->ready_head = conn->ready_next;
+    if (!loop->ready_head) loop->ready_tail = NULL;
+    conn->in_ready = 0;
+    return conn;
+}
+
+// --- Timer heap: paced connections waiting for their next due time ---
+// conn->sleep_slot is the connection's heap index + 1, so it can be removed
+// when it closes while waiting.
+void loop_timer_set(event_loop_t *loop, int i, connection_t *conn) {
+    loop->timers[i] = conn;
+    conn->sleep_slot = i + 1;
+}
+
+void loop_timer_sift(event_loop_t *loop, int i) {
+    connection_t *conn = loop->timers[i];
+    // Up while earlier than the parent ...
+    while (i > 0 && conn->pace_due_ns < loop->timers[(i - 1) / 2]->pace_due_ns) {
+        loop_timer_set(loop, i, loop->timers[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+    // ... then down while later than the earliest child.
+    while (2 * i + 1 < loop->timer_count) {
+        int child = 2 * i + 1;
+        if (child + 1 < loop->timer_count &&
+            loop->timers[child + 1]->pace_due_ns < loop->timers[child]->pace_due_ns)
+            child++;
+        if (loop->timers[child]->pace_due_ns >= conn->pace_due_ns) break;
+        loop_timer_set(loop, i, loop->timers[child]);
+        i = child;
+    }
+    loop_timer_set(loop, i, conn);
+}
+
+// Park a connection until conn->pace_due_ns. Returns -1 if out of memory.
+int loop_sleep(event_loop_t *loop, connection_t *conn) {
+    if (conn->sleep_slot) return 0;
+    if (loop->timer_count == loop->timer_cap) {
+        int cap = loop->timer_cap ? 2 * loop->timer_cap : 64;
+        connection_t **timers = realloc(loop->timers, cap * sizeof(connection_t *));
+        if (!timers) return -1;
+        loop->timers = timers;
+        loop->timer_cap = cap;
+    }
+    loop_timer_set(loop, loop->timer_count++, conn);
+    loop_timer_sift(loop, loop->timer_count - 1);
+    return 0;
+}
+
+void loop_timer_remove(event_loop_t *loop, connection_t *conn) {
+    int i = conn->sleep_slot - 1;
+    conn->sleep_slot = 0;
+    if (--loop->timer_count == i) return;
+    loop_timer_set(loop, i, loop->timers[loop->timer_count]);
+    loop_timer_sift(loop, i);
+}
+
+// Move every connection that is due by now to the ready queue.
+void loop_wake_due(event_loop_t *loop) {
+    uint64_t now = run_now_ns();
+    while (loop->timer_count > 0 && loop->timers[0]->pace_due_ns <= now) {
+        connection_t *conn = loop->timers[0];
+        loop_timer_remove(loop, conn);
+        loop_push_ready(loop, conn);
+    }
+}
+
+// A connection whose zero-copy sends the kernel still holds cannot free its
+// payload yet, and waiting here would stall every other connection of the
+// loop. It lingers instead: the client gets EOF now, EPOLLERR keeps
+// bringing completions, and the last one (or EPOLL_LINGER_MS) releases it.
+void loop_close_connection(event_loop_t *loop, connection_t *conn) {
+    if (conn->sleep_slot) loop_timer_remove(loop, conn);
+    if (conn->phase == CONN_SENDING) {
+        if (conn->ops->on_error_queue) conn->ops->on_error_queue(conn);
+        printf("[Loop %d] Finished. Sent %zu bytes (%llu in the measurement window).\n", loop->id,
+               conn->total_bytes_sent,
+               (unsigned long long)run_window_bytes(&conn->clock, conn->total_bytes_sent));
+        pace_report(conn, "Loop", loop->id);
+        perf_report(conn, "Loop", loop->id);
+        if (server_running && conn->ops->in_flight && conn->ops->in_flight(conn) > 0) {
+            conn->phase = CONN_LINGER;
+            conn->linger_until_ns = run_now_ns() + EPOLL_LINGER_MS * 1000000ULL;
+            shutdown(conn->sock, SHUT_WR);
+            return;
+        }
+        release_connection(conn);
+    } else if (conn->phase == CONN_LINGER) {
+        release_connection(conn);
+    } else {
+        close(conn->sock);
+    }
+
+    // Unlink from the live list
+    if (conn->prev) conn->prev->next = conn->next;
+    else loop->conns = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+
+    // Still referenced by the ready queue: let loop_pop_ready() hand it back for freeing.
+    if (conn->in_ready) conn->closing = 1;
+    else free(conn);
+}
+
+void loop_accept(event_loop_t *loop) {
+    while (1) {
+        int sock = accept4(loop->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sock < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept4");
+            return; // Drained the backlog (or another loop won the race)
+        }
+
+        connection_t *conn = calloc(1, sizeof(connection_t));
+        if (!conn) {
+            close(sock);
+            continue;
+        }
+        conn->sock = conn->ctrl = sock;
+        conn->ops = loop->ops;
+        conn->phase = CONN_HANDSHAKE;
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, sock, &ev) < 0) {
+            perror("epoll_ctl");
+            close(sock);
+            free(conn);
+            continue;
+        }
+
+        conn->next = loop->conns;
+        if (loop->conns) loop->conns->prev = conn;
+        loop->conns = conn;
+    }
+}
+
+// Ping-pong: count every complete request that has arrived so far.
+// The request bodies carry nothing the server needs, only their number matters.
+// Returns -1 when the client went away.
+int loop_read_requests(connection_t *conn) {
+    char buf[4096];
+    while (1) {
+        ssize_t n = recv(conn->sock, buf, sizeof(buf), 0);
+        if (n > 0) {
+            size_t total = conn->req_len + (size_t)n;
+            conn->pending_requests += total / sizeof(request_t);
+            conn->req_len = total % sizeof(request_t);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        return -1;
+    }
+}
+
+// Read as much of the handshake_t as is available.
+// Returns 0 while incomplete / done, -1 when the connection should be closed.
+int loop_read_handshake(event_loop_t *loop, connection_t *conn) {
+    while (conn->hs_len < sizeof(conn->hs_buf)) {
+        ssize_t n = recv(conn->sock, conn->hs_buf + conn->hs_len,
+                         sizeof(conn->hs_buf) - conn->hs_len, 0);
+        if (n > 0) {
+            conn->hs_len += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        return -1; // EOF or error before the handshake completed
+    }
+
+    if (apply_handshake(conn, conn->hs_buf) < 0) return -1;
+    printf("[Loop %d] %s: Size=%zu, Fields=%d (%s), Duration=%d ms (+%d ms warmup), Pattern=%s%s\n",
+           loop->id, conn->ops->name, conn->msg_size, conn->fields, layout_names[conn->layout],
+           conn->duration_ms, conn->warmup_ms, pattern_name(conn->pattern), conn->framed ? ", framed" : "");
+    if (prepare_connection(conn) != 0) return -1;
+    conn->phase = CONN_SENDING;
+
+    // Edge-triggered: requests that arrived together with the handshake
+    // will not raise another EPOLLIN, so pick them up now.
+    if (conn->pattern == PATTERN_PINGPONG && loop_read_requests(conn) < 0) return -1;
+    loop_push_ready(loop, conn);
+    return 0;
+}
+
+// Send up to EPOLL_SEND_BUDGET messages. Returns -1 if the connection is done.
+int loop_send(event_loop_t *loop, connection_t *conn) {
+    unsigned long target = conn->messages_sent + EPOLL_SEND_BUDGET;
+
+    while (conn->messages_sent < target) {
+        if (!server_running || run_tick(&conn->clock, conn->total_bytes_sent) == RUN_DONE) return -1;
+
+        // Open loop: not due yet, wait in the timer heap.
+        if (pace_wait_ns(conn) > 0) return loop_sleep(loop, conn);
+
+        // Ping-pong: nothing to answer yet, EPOLLIN will bring the next request.
+        int pingpong = (conn->pattern == PATTERN_PINGPONG);
+        if (pingpong && conn->msg_offset == 0 && conn->pending_requests == 0) return 0;
+
+        ssize_t sent = conn->ops->send_message(conn, batch_send_flags(conn));
+        metrics_add(METRIC_SYSCALLS, 1);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                metrics_add(METRIC_EAGAIN, 1);
+                return 0; // EPOLLOUT will wake us
+            }
+            return -1;
+        }
+        unsigned long before = conn->messages_sent;
+        record_progress(conn, sent);
+        batch_progress(conn, before);
+        pace_progress(conn, before);
+        if (pingpong) conn->pending_requests -= conn->messages_sent - before;
+    }
+
+    // Budget used up but the socket is still writable: go to the back of the queue.
+    loop_push_ready(loop, conn);
+    return 0;
+}
+
+void loop_handle_event(event_loop_t *loop, connection_t *conn, uint32_t events) {
+    if (conn->phase == CONN_LINGER) {
+        if (events & EPOLLERR) conn->ops->on_error_queue(conn);
+        if (conn->ops->in_flight(conn) == 0) loop_close_connection(loop, conn);
+        return;
+    }
+    if (events & (EPOLLHUP | EPOLLRDHUP)) {
+        loop_close_connection(loop, conn);
+        return;
+    }
+    if (events & EPOLLERR) {
+        // With MSG_ZEROCOPY, completions arrive on the error queue and raise EPOLLERR.
+        if (conn->phase == CONN_SENDING && conn->ops->on_error_queue) {
+            conn->ops->on_error_queue(conn);
+            // The transport may have been waiting for these completions
+            // to free a buffer, so give it another turn.
+            loop_push_ready(loop, conn);
+        } else {
+            loop_close_connection(loop, conn);
+            return;
+        }
+    }
+    if (conn->phase == CONN_HANDSHAKE) {
+        if ((events & EPOLLIN) && loop_read_handshake(loop, conn) < 0)
+            loop_close_connection(loop, conn);
+        return;
+    }
+    if ((events & EPOLLIN) && conn->pattern == PATTERN_PINGPONG) {
+        if (loop_read_requests(conn) < 0) {
+            loop_close_connection(loop, conn);
+            return;
+        }
+        if (conn->pending_requests > 0) loop_push_ready(loop, conn);
+    }
+    if (events & EPOLLOUT) loop_push_ready(loop, conn);
+}
+
+void loop_expire_connections(event_loop_t *loop) {
+    uint64_t now = run_now_ns();
+    connection_t *conn = loop->conns;
+    while (conn) {
+        connection_t *next = conn->next;
+        if (conn->phase == CONN_SENDING && (!server_running || now >= conn->clock.end_ns)) {
+            loop_close_connection(loop, conn);
+        } else if (conn->phase == CONN_SENDING && conn->retry_tick) {
+            // The transport backed off without a full socket (A3 ENOBUFS)
+            conn->retry_tick = 0;
+            loop_push_ready(loop, conn);
+        } else if (conn->phase == CONN_LINGER) {
+            // Completions that came without a new EPOLLERR edge, or the last look
+            conn->ops->on_error_queue(conn);
+            if (!server_running || now >= conn->linger_until_ns || conn->ops->in_flight(conn) == 0)
+                loop_close_connection(loop, conn);
+        }
+        conn = next;
+    }
+}
+
+void *event_loop_thread(void *arg) {
+    event_loop_t *loop = (event_loop_t *)arg;
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    uint64_t last_sweep = run_now_ns();
+
+    if (loop->cpu >= 0) pin_thread_to_cpu(loop->cpu);
+    pace_tight_timers(); // Any of its connections may be paced
+    char role[20];
+    snprintf(role, sizeof(role), "loop %d", loop->id);
+    metrics_claim(role);
+    perf_thread_open();
+
+    while (server_running) {
+        // Don't sleep while some connection still has budgeted work queued,
+        // nor past the due time of the earliest paced connection.
+        uint64_t wait_ns = loop->ready_head ? 0 : EPOLL_TICK_MS * 1000000ULL;
+        if (wait_ns > 0 && loop->timer_count > 0) {
+            uint64_t now = run_now_ns(), due = loop->timers[0]->pace_due_ns;
+            if (due <= now) wait_ns = 0;
+            else if (due - now < wait_ns) wait_ns = due - now;
+        }
+        struct timespec timeout = { (time_t)(wait_ns / 1000000000ULL), (long)(wait_ns % 1000000000ULL) };
+        int n = epoll_pwait2(loop->epfd, events, EPOLL_MAX_EVENTS, &timeout, NULL);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_pwait2");
+            break;
+        }
+        if (n < 0) n = 0;
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == NULL) loop_accept(loop);
+            else loop_handle_event(loop, (connection_t *)events[i].data.ptr, events[i].events);
+        }
+        loop_wake_due(loop);
+
+        // Drain one round of the ready queue (new arrivals wait for the next round).
+        connection_t *stop = loop->ready_tail;
+        connection_t *conn;
+        while (stop && (conn = loop_pop_ready(loop)) != NULL) {
+            int last = (conn == stop);
+            if (conn->closing) {
+                free(conn);
+            } else if (conn->phase == CONN_SENDING) {
+                perf_sample_t perf_mark;
+                perf_begin(&perf_mark);
+                int done = loop_send(loop, conn) < 0;
+                perf_end(conn, &perf_mark);
+                if (done) loop_close_connection(loop, conn);
+            }
+            if (last) break;
+        }
+
+        // Clients that stopped reading never become writable again; expire them here.
+        uint64_t now = run_now_ns();
+        if (now - last_sweep >= EPOLL_TICK_MS * 1000000ULL) {
+            last_sweep = now;
+            loop_expire_connections(loop);
+        }
+    }
+    perf_thread_close();
+    metrics_release();
+    return NULL;
+}
+
+// Start the event loops and wait for them. Either all loops share one
+// listener (listener_count == 1) or loop i owns SO_REUSEPORT listener i.
+void run_event_loops(const int *listen_fds, int listener_count,
+                     const transport_ops_t *ops, const server_config_t *cfg) {
+    int count = cfg->event_loops;
+    for (int i = 0; i < listener_count; i++)
+        fcntl(listen_fds[i], F_SETFL, fcntl(listen_fds[i], F_GETFL) | O_NONBLOCK);
+
+    event_loop_t *loops = calloc(count, sizeof(event_loop_t));
+    pthread_t *threads = calloc(count, sizeof(pthread_t));
+
+    for (int i = 0; i < count; i++) {
+        loops[i].id = i;
+        loops[i].listen_fd = listen_fds[i % listener_count];
+        loops[i].cpu = worker_cpu(cfg, i);
+        loops[i].ops = ops;
+        loops[i].epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (loops[i].epfd < 0) {
+            perror("epoll_create1");
+            exit(EXIT_FAILURE);
+        }
+
+        // A shared listener uses EPOLLEXCLUSIVE to wake one loop per incoming
+        // connection instead of all of them.
+        struct epoll_event ev;
+        ev.events = EPOLLIN | (listener_count == 1 ? EPOLLEXCLUSIVE : 0);
+        ev.data.ptr = NULL; // NULL marks the listening socket
+        if (epoll_ctl(loops[i].epfd, EPOLL_CTL_ADD, loops[i].listen_fd, &ev) < 0) {
+            perror("epoll_ctl listener");
+            exit(EXIT_FAILURE);
+        }
+
+        if (pthread_create(&threads[i], NULL, event_loop_thread, &loops[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        pthread_join(threads[i], NULL);
+        close(loops[i].epfd);
+        free(loops[i].timers);
+    }
+    free(threads);
+    free(loops);
+}
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Frame.h
+ * Description: Framed wire format (handshake_t.framing = FRAMING_ON).
+ * By default the stream is a bare sequence of msg_size-byte messages, so the
+ * client can only count bytes. A framed connection puts a header in front of
+ * every message:
+ *
+ *   [magic][CRC32C of the payload][sequence number][payload length][payload]
+ *
+ * The server sends the header as one more iovec (or one more stitched block
+ * in A1), so the payload itself is still not copied. The client checks the
+ * magic, the length and that sequence numbers have no gaps, and recomputes
+ * the CRC32C of every payload: with the SSE4.2 crc32 instruction when the
+ * CPU has it, a table otherwise.
+ * Header fields are in host byte order, like the handshake.
+ * Shared by the servers and the client.
+ */
+
+#ifndef MT25073_PART_A_FRAME_H
+#define MT25073_PART_A_FRAME_H
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "MT25073_Part_A_Clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FRAME_X86 1
+#endif
+
+#define FRAME_MAGIC 0x3532544dU // "MT25" in memory on little-endian hosts
+
+typedef struct {
+    uint32_t magic;     // FRAME_MAGIC
+    uint32_t crc32c;    // CRC32C of the payload bytes
+    uint64_t seq;       // 0, 1, 2, ... per connection
+    uint64_t length;    // Payload bytes that follow
+} frame_header_t;
+
+#define FRAME_HDR sizeof(frame_header_t) // 24 bytes on the wire
+
+// --- CRC32C (Castagnoli, reflected polynomial 0x82F63B78) ---
+uint32_t crc32c_table[256];
+pthread_once_t crc32c_table_once = PTHREAD_ONCE_INIT;
+
+void crc32c_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1)));
+        crc32c_table[i] = crc;
+    }
+}
+
+// Software fallback: one table lookup per byte.
+uint32_t crc32c_sw(uint32_t crc, const void *buf, size_t len) {
+    const unsigned char *p = (const unsigned char *)buf;
+    pthread_once(&crc32c_table_once, crc32c_table_init);
+    crc = ~crc;
+    while (len--) crc = (crc >> 8) ^ crc32c_table[(crc ^ *p++) & 0xff];
+    return ~crc;
+}
+
+#ifdef FRAME_X86
+// SSE4.2 crc32 instruction: 8 bytes per step, bytes for the ends.
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw(uint32_t crc, const void *buf, size_t len) {
+    const unsigned char *p = (const unsigned char *)buf;
+    uint64_t c = ~crc;
+    for (; len > 0 && ((uintptr_t)p & 7); len--) c = _mm_crc32_u8((uint32_t)c, *p++);
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    for (; len > 0; len--) c = _mm_crc32_u8((uint32_t)c, *p++);
+    return ~(uint32_t)c;
+}
+#endif
+
+typedef uint32_t (*crc32c_fn)(uint32_t crc, const void *buf, size_t len);
+
+// Fastest implementation this CPU supports; *name describes it.
+crc32c_fn crc32c_select(const char **name) {
+#ifdef FRAME_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        if (name) *name = "sse4.2";
+        return crc32c_hw;
+    }
+#endif
+    if (name) *name = "table";
+    return crc32c_sw;
+}
+
+// CRC32C of buf, continuing from crc (start with 0).
+uint32_t crc32c(uint32_t crc, const void *buf, size_t len) {
+    static crc32c_fn impl = NULL;
+    if (!impl) impl = crc32c_select(NULL); // Same answer on every thread, so no lock
+    return impl(crc, buf, len);
+}
+
+// --- Client side: verifies a framed stream chunk by chunk ---
+// recv() returns arbitrary pieces of the stream, so headers and payloads
+// may be split over several calls: the verifier keeps its place in between.
+typedef struct {
+    size_t payload_len;             // Expected length field (the requested msg_size)
+    int check_crc;                  // 0 = only check headers and sequence numbers
+    unsigned char hdr[FRAME_HDR];   // Header being assembled
+    size_t hdr_have;
+    frame_header_t cur;             // Header of the payload being read
+    size_t body_left;               // Payload bytes still to come (0 = expecting a header)
+    uint32_t crc;                   // Running CRC32C of the current payload
+    uint64_t next_seq;
+    int lost;                       // Bad magic/length: no way to find the next header
+
+    // Results
+    unsigned long frames;           // Frames that passed every check
+    unsigned long bad_seq;          // Sequence number gaps (resynchronised afterwards)
+    unsigned long bad_crc;
+    unsigned long bad_header;       // Wrong magic or length (stream given up)
+    long long good_bytes;           // Payload bytes of the frames that passed
+    uint64_t crc_ns;                // Time spent computing checksums
+} frame_verifier_t;
+
+void frame_verifier_init(frame_verifier_t *fv, size_t payload_len, int check_crc) {
+    memset(fv, 0, sizeof(*fv));
+    fv->payload_len = payload_len;
+    fv->check_crc = check_crc;
+}
+
+void frame_finish(frame_verifier_t *fv) {
+    int ok = fv->cur.seq == fv->next_seq;
+    if (!ok) fv->bad_seq++;
+    fv->next_seq = fv->cur.seq + 1;
+    if (fv->check_crc && fv->crc != fv->cur.crc32c) {
+        fv->bad_crc++;
+        ok = 0;
+    }
+    if (ok) {
+        fv->frames++;
+        fv->good_bytes += fv->cur.length;
+    }
+}
+
+// Feed the next `len` bytes of the stream.
+void frame_verify(frame_verifier_t *fv, const char *data, size_t len) {
+    while (len > 0 && !fv->lost) {
+        // 1. HEADER: collect all FRAME_HDR bytes, then check it
+        if (fv->body_left == 0) {
+            size_t take = FRAME_HDR - fv->hdr_have;
+            if (take > len) take = len;
+            memcpy(fv->hdr + fv->hdr_have, data, take);
+            fv->hdr_have += take;
+            data += take, len -= take;
+            if (fv->hdr_have < FRAME_HDR) return;
+
+            fv->hdr_have = 0;
+            memcpy(&fv->cur, fv->hdr, FRAME_HDR);
+            if (fv->cur.magic != FRAME_MAGIC || fv->cur.length != fv->payload_len) {
+                fv->bad_header++;
+                fv->lost = 1;
+                return;
+            }
+            fv->body_left = fv->cur.length;
+            fv->crc = 0;
+            continue;
+        }
+
+        // 2. PAYLOAD: checksum what arrived of it
+        size_t take = fv->body_left < len ? fv->body_left : len;
+        if (fv->check_crc) {
+            uint64_t t0 = run_now_ns();
+            fv->crc = crc32c(fv->crc, data, take);
+            fv->crc_ns += run_now_ns() - t0;
+        }
+        data += take, len -= take;
+        fv->body_left -= take;
+        if (fv->body_left == 0) frame_finish(fv);
+    }
+}
+
+#endif
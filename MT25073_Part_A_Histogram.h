@@ -0,0 +1,105 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Histogram.h
+ * Description: HDR-style latency histogram (log-linear buckets).
+ * Values below 128 ns are exact, above that every power of two is split
+ * into 64 sub-buckets (< 1.6% relative error) across the whole 64-bit range.
+ * Each client thread owns one histogram, so recording needs no locks or
+ * atomics; the threads' histograms are merged after pthread_join().
+ */
+
+#ifndef MT25073_PART_A_HISTOGRAM_H
+#define MT25073_PART_A_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "MT25073_Part_A_Clock.h"
+
+#define HIST_SUB_BUCKETS 64                          // Sub-buckets per power of two
+#define HIST_BUCKETS     (58 * HIST_SUB_BUCKETS + 2 * HIST_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+} latency_histogram_t;
+
+void hist_init(latency_histogram_t *h) {
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+int hist_index(uint64_t value) {
+    if (value < 2 * HIST_SUB_BUCKETS) return (int)value;
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - 6;                              // value >> shift lands in [64, 127]
+    return shift * HIST_SUB_BUCKETS + (int)(value >> shift);
+}
+
+// Highest value that maps to the same bucket (what HdrHistogram reports).
+uint64_t hist_bucket_value(int index) {
+    if (index < 2 * HIST_SUB_BUCKETS) return (uint64_t)index;
+    int shift = index / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index % HIST_SUB_BUCKETS + HIST_SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void hist_record(latency_histogram_t *h, uint64_t value_ns) {
+    h->counts[hist_index(value_ns)]++;
+    h->total++;
+    h->sum += (double)value_ns;
+    if (value_ns < h->min) h->min = value_ns;
+    if (value_ns > h->max) h->max = value_ns;
+}
+
+// `count` samples of the same value at once.
+void hist_record_n(latency_histogram_t *h, uint64_t value_ns, uint64_t count) {
+    h->counts[hist_index(value_ns)] += count;
+    h->total += count;
+    h->sum += (double)value_ns * count;
+    if (value_ns < h->min) h->min = value_ns;
+    if (value_ns > h->max) h->max = value_ns;
+}
+
+void hist_merge(latency_histogram_t *dst, const latency_histogram_t *src) {
+    for (int i = 0; i < HIST_BUCKETS; i++) dst->counts[i] += src->counts[i];
+    dst->total += src->total;
+    dst->sum += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// Value at percentile p (0..100). The top percentile is clamped to the exact max.
+uint64_t hist_percentile(const latency_histogram_t *h, double p) {
+    if (h->total == 0) return 0;
+    uint64_t rank = (uint64_t)((p / 100.0) * (double)h->total + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t v = hist_bucket_value(i);
+            return v > h->max ? h->max : v;
+        }
+    }
+    return h->max;
+}
+
+double hist_mean(const latency_histogram_t *h) {
+    return h->total ? h->sum / (double)h->total : 0.0;
+}
+
+// One line, microseconds, parsed by MT25073_Part_C_Runner.sh
+void hist_print(const char *label, const latency_histogram_t *h) {
+    printf("%s p50=%.2f p90=%.2f p99=%.2f p99.9=%.2f max=%.2f mean=%.2f (us, n=%llu)\n",
+           label,
+           hist_percentile(h, 50.0) / 1e3, hist_percentile(h, 90.0) / 1e3,
+           hist_percentile(h, 99.0) / 1e3, hist_percentile(h, 99.9) / 1e3,
+           h->max / 1e3, hist_mean(h) / 1e3,
+           (unsigned long long)h->total);
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Metrics.h
+ * Description: Live server metrics in shared memory.
+ * The server maps a small file in /dev/shm (default METRICS_PATH, -s) and
+ * every worker - connection thread, pooled worker or epoll loop - claims a
+ * slot in it. The worker adds to its own slot's counters as it sends, with
+ * plain stores on a cache line no other thread writes, so counting costs a
+ * few instructions per syscall. Any process can map the file read-only and
+ * watch the counters move while the run is going (MT25073_Part_E_MetricsTop.c).
+ *
+ *   [metrics_header_t][metrics_slot_t 0][metrics_slot_t 1] ...
+ *
+ * Counters only grow; a reader takes two snapshots and divides the
+ * difference by the time between them. A slot whose worker exits keeps its
+ * totals and is handed to the next worker. When all slots are taken, later
+ * workers share the last one with atomic adds.
+ * A server holds an flock() on its file for as long as it runs, so a second
+ * server given the same file leaves it alone instead of wiping the first
+ * one's counters (the lock goes away with the process, even on a crash).
+ * Shared by the servers and the reader.
+ */
+
+#ifndef MT25073_PART_A_METRICS_H
+#define MT25073_PART_A_METRICS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include "MT25073_Part_A_Clock.h"
+
+#define METRICS_PATH    "/dev/shm/MT25073_metrics"
+#define METRICS_MAGIC   0x5254454dU // "METR" in memory on little-endian hosts
+#define METRICS_VERSION 1
+#define METRICS_SLOTS   1024
+
+#define METRIC_BYTES        0 // Bytes accepted by the kernel
+#define METRIC_MESSAGES     1 // Complete messages sent
+#define METRIC_SYSCALLS     2 // Send calls (A4: io_uring submissions) + A3 error queue reads
+#define METRIC_EAGAIN       3 // Epoll engine: socket full, waiting for EPOLLOUT
+#define METRIC_ENOBUFS      4 // A3: kernel out of zero-copy notification memory
+#define METRIC_ZC_DONE      5 // Zero-copy sends completed (A3, A4 SEND_ZC)
+#define METRIC_ZC_COPIED    6 // ... of which the kernel copied after all
+#define METRIC_CONNECTIONS  7 // Connections accepted
+#define METRIC_COUNT        8
+
+const char *metric_names[METRIC_COUNT] = {
+    "bytes", "messages", "syscalls", "eagain", "enobufs", "zc_done", "zc_copied", "connections"
+};
+
+typedef struct {
+    uint32_t magic;               // METRICS_MAGIC once the header is complete
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;           // sizeof(metrics_slot_t), checked by readers
+    int32_t pid;                  // Server process (readers stop when it is gone)
+    int32_t port;
+    uint64_t start_ns;            // CLOCK_MONOTONIC when the server started
+    char server[32];              // Transport name, e.g. "A2 One-Copy"
+} __attribute__((aligned(64))) metrics_header_t;
+
+typedef struct {
+    uint64_t counters[METRIC_COUNT]; // First cache line: written by the owner only
+    int32_t in_use;               // A worker owns the slot
+    int32_t shared;               // Overflow slot: several workers, atomic adds
+    int32_t tid;                  // Owner's kernel thread id
+    char role[20];                // "thread", "worker 3", "loop 1", ...
+} __attribute__((aligned(64))) metrics_slot_t;
+
+metrics_header_t *metrics_header = NULL;
+metrics_slot_t *metrics_slots = NULL;
+metrics_slot_t metrics_unexported;  // Workers without a slot count here (nobody reads it)
+__thread metrics_slot_t *metrics_self = &metrics_unexported;
+
+size_t metrics_region_size(uint32_t slots) {
+    return sizeof(metrics_header_t) + (size_t)slots * sizeof(metrics_slot_t);
+}
+
+// Create (or reset) the region at `path`. Returns 0 on success; on failure
+// - or when another live server owns the file - the counters still work but
+// nobody can see them.
+int metrics_open(const char *path, const char *server, int port) {
+    size_t len = metrics_region_size(METRICS_SLOTS);
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("metrics: cannot create the shared-memory file");
+        return -1;
+    }
+    // Only reset the file once it is ours; the descriptor (and the lock)
+    // stays open until the process exits.
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        metrics_header_t owner;
+        memset(&owner, 0, sizeof(owner));
+        if (pread(fd, &owner, sizeof(owner), 0) < 0) owner.pid = 0;
+        fprintf(stderr, "metrics: %s is in use by another server (pid %d); "
+                        "choose another file with -s, or -s off\n", path, (int)owner.pid);
+        close(fd);
+        return -1;
+    }
+    if (ftruncate(fd, 0) < 0 || ftruncate(fd, len) < 0) {
+        perror("metrics: cannot create the shared-memory file");
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        perror("metrics: mmap");
+        return -1;
+    }
+
+    metrics_header = (metrics_header_t *)base;
+    metrics_slots = (metrics_slot_t *)((char *)base + sizeof(metrics_header_t));
+    metrics_header->version = METRICS_VERSION;
+    metrics_header->slot_count = METRICS_SLOTS;
+    metrics_header->slot_size = sizeof(metrics_slot_t);
+    metrics_header->pid = getpid();
+    metrics_header->port = port;
+    metrics_header->start_ns = run_now_ns();
+    strncpy(metrics_header->server, server, sizeof(metrics_header->server) - 1);
+    // Readers check the magic last: it is only visible once the rest is set.
+    __atomic_store_n(&metrics_header->magic, METRICS_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Give the calling thread a slot of its own; `role` names it for readers.
+void metrics_claim(const char *role) {
+    if (!metrics_slots) return;
+    metrics_slot_t *slot = &metrics_slots[METRICS_SLOTS - 1]; // Overflow: shared
+    for (int i = 0; i < METRICS_SLOTS - 1; i++) {
+        int32_t free_slot = 0;
+        if (__atomic_compare_exchange_n(&metrics_slots[i].in_use, &free_slot, 1, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            slot = &metrics_slots[i];
+            break;
+        }
+    }
+    if (slot == &metrics_slots[METRICS_SLOTS - 1]) {
+        __atomic_store_n(&slot->shared, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->in_use, 1, __ATOMIC_RELAXED);
+        role = "shared";
+    }
+    slot->tid = (int32_t)syscall(SYS_gettid);
+    strncpy(slot->role, role, sizeof(slot->role) - 1);
+    metrics_self = slot;
+}
+
+// The calling thread is exiting: its slot (and totals) go to the next worker.
+void metrics_release(void) {
+    metrics_slot_t *slot = metrics_self;
+    metrics_self = &metrics_unexported;
+    if (slot == &metrics_unexported || slot->shared) return;
+    __atomic_store_n(&slot->in_use, 0, __ATOMIC_RELEASE);
+}
+
+// Count on the calling thread's slot. An owned slot has one writer, so a
+// relaxed load + store suffices (and a reader never sees a torn value).
+void metrics_add(int metric, uint64_t value) {
+    uint64_t *c = &metrics_self->counters[metric];
+    if (__builtin_expect(metrics_self->shared, 0)) {
+        __atomic_fetch_add(c, value, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_store_n(c, __atomic_load_n(c, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Pace.h
+ * Description: Open-loop send schedule (handshake_t.rate > 0).
+ * A closed-loop client only ever measures the server at saturation. In
+ * open-loop mode the client asks for a fixed message rate per connection
+ * and the server sends message i at its scheduled time, no earlier and
+ * no matter how late the previous one was:
+ *   constant : one message every 1/rate seconds
+ *   poisson  : exponentially distributed gaps with mean 1/rate
+ * Both ends derive the same schedule from (rate, arrivals, seed, start), so
+ * the client knows when every message was SUPPOSED to be sent and measures
+ * its latency from that instant. The start is the client's CLOCK_MONOTONIC
+ * time of the handshake, which the server shares on the same host.
+ * A server that falls behind therefore shows up as latency of every
+ * message it delayed, not just of the one it stalled on (no "coordinated
+ * omission").
+ * Shared by the servers and the client.
+ */
+
+#ifndef MT25073_PART_A_PACE_H
+#define MT25073_PART_A_PACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "MT25073_Part_A_Clock.h"
+
+#define PACE_MAX_SKEW_NS 1000000000ULL // handshake_t.start_ns older than this: not our clock
+
+#define ARRIVALS_CONSTANT 0
+#define ARRIVALS_POISSON  1
+#define ARRIVALS_COUNT    2
+
+const char *arrival_names[ARRIVALS_COUNT] = { "constant", "poisson" };
+
+int arrival_id(const char *name) {
+    for (int i = 0; i < ARRIVALS_COUNT; i++)
+        if (strcmp(name, arrival_names[i]) == 0) return i;
+    return -1;
+}
+
+typedef struct {
+    int arrivals;      // ARRIVALS_*
+    double gap_ns;     // Mean gap between messages
+    uint64_t rng;      // splitmix64 state (poisson)
+    double next_ns;    // Offset of the next message from the start of the schedule
+} pace_t;
+
+void pace_init(pace_t *p, uint32_t rate, int arrivals, uint32_t seed) {
+    p->arrivals = arrivals;
+    p->gap_ns = 1e9 / rate;
+    p->rng = seed;
+    p->next_ns = 0; // Message 0 is due right away
+}
+
+uint64_t pace_random(pace_t *p) {
+    uint64_t z = (p->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Offset (ns from the start of the schedule) at which the next message is
+// due; advances the schedule by one message.
+uint64_t pace_next(pace_t *p) {
+    uint64_t due = (uint64_t)p->next_ns;
+    if (p->arrivals == ARRIVALS_POISSON) {
+        double u = (pace_random(p) >> 11) * 0x1.0p-53; // [0, 1)
+        p->next_ns += -log(1.0 - u) * p->gap_ns;
+    } else {
+        p->next_ns += p->gap_ns;
+    }
+    return due;
+}
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Payload.h
+ * Description: Shared, read-only payload cache.
+ * Every connection of the same message size sends the same bytes ('A'+i in
+ * field i), so the ComplexMessage is built once per (size, field layout,
+ * NUMA node) and shared by reference count. New connections skip the
+ * allocation and memset entirely, and 1000 clients at 1 MB need 1 MB of
+ * payload per node instead of 1 GB.
+ * The payload's CRC32C is computed here too, once, for framed connections,
+ * and so is its memfd copy for the file-backed transports (A5).
+ * Payloads nobody references are kept (up to PAYLOAD_IDLE_BYTES, oldest
+ * evicted first) so back-to-back runs reuse them.
+ * Included by MT25073_Part_A_Server.h (needs create_payload_arena()).
+ */
+
+#ifndef MT25073_PART_A_PAYLOAD_H
+#define MT25073_PART_A_PAYLOAD_H
+
+#define PAYLOAD_IDLE_BYTES (64UL * 1024 * 1024)   // Unreferenced payloads kept for reuse
+
+typedef struct payload {
+    // Cache key
+    size_t msg_size;
+    int fields;                // Field count
+    int layout;                // FIELDS_*
+    int node;                  // NUMA node the arena is bound to (-1 unknown)
+    // Read-only after creation
+    ComplexMessage msg;
+    arena_t arena;
+    uint32_t crc;              // CRC32C of all fields in order (frame headers)
+    // Protected by payload_cache_lock
+    int memfd;                 // The fields back to back in a memfd, built on first use (-1: not yet)
+    int refs;
+    unsigned long last_used;   // Eviction order for idle payloads
+    struct payload *next;
+} payload_t;
+
+payload_t *payload_cache = NULL;
+pthread_mutex_t payload_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+unsigned long payload_clock = 0;
+
+void payload_destroy(payload_t *p) {
+    if (p->memfd >= 0) close(p->memfd);
+    free_complex_message_arena(&p->msg, &p->arena);
+    arena_destroy(&p->arena);
+    free(p);
+}
+
+// Get the shared payload for this size and layout on the caller's NUMA node
+// (refs + 1). Returns NULL only if memory runs out.
+payload_t *payload_acquire(size_t msg_size, int fields, int layout) {
+    int node = arena_current_node();
+
+    pthread_mutex_lock(&payload_cache_lock);
+    payload_t *p;
+    for (p = payload_cache; p; p = p->next) {
+        if (p->msg_size == msg_size && p->fields == fields && p->layout == layout &&
+            p->node == node)
+            break;
+    }
+    if (!p) {
+        // First connection of this size on this node: build it once.
+        // Filling under the lock keeps a second connection from building a duplicate.
+        p = calloc(1, sizeof(payload_t));
+        if (!p) {
+            pthread_mutex_unlock(&payload_cache_lock);
+            return NULL;
+        }
+        p->msg_size = msg_size;
+        p->fields = fields;
+        p->layout = layout;
+        p->memfd = -1;
+        create_payload_arena(&p->arena, msg_size, fields, 1);
+        p->node = p->arena.base ? p->arena.node : node;
+        if (fill_complex_message_arena(&p->msg, msg_size, fields, layout, &p->arena) != 0) {
+            arena_destroy(&p->arena);
+            free(p);
+            pthread_mutex_unlock(&payload_cache_lock);
+            return NULL;
+        }
+        for (int i = 0; i < p->msg.count; i++)
+            p->crc = crc32c(p->crc, p->msg.fields[i], p->msg.sizes[i]);
+        p->next = payload_cache;
+        payload_cache = p;
+        printf("[Thread %ld] Payload cache: built %zu bytes in %d %s fields, %s pages, node %d, align %zu\n",
+               pthread_self(), msg_size, fields, layout_names[layout],
+               arena_pages_name(p->arena.pages), p->node, p->arena.base ? p->arena.align : 0);
+    }
+    p->refs++;
+    pthread_mutex_unlock(&payload_cache_lock);
+    return p;
+}
+
+// The payload as a file: a memfd holding the fields back to back, written
+// once for all connections of this payload and closed with it. Readers use
+// explicit offsets (sendfile/splice with an offset pointer), never the
+// shared file position. Returns -1 if it cannot be created.
+int payload_memfd(payload_t *p) {
+    pthread_mutex_lock(&payload_cache_lock);
+    if (p->memfd < 0) {
+        int fd = memfd_create("complex_message", MFD_CLOEXEC);
+        if (fd < 0) perror("memfd_create");
+        off_t pos = 0;
+        for (int i = 0; fd >= 0 && i < p->msg.count; i++) {
+            size_t done = 0;
+            while (done < p->msg.sizes[i]) {
+                ssize_t n = pwrite(fd, p->msg.fields[i] + done, p->msg.sizes[i] - done, pos + done);
+                if (n <= 0) {
+                    perror("memfd write");
+                    close(fd);
+                    fd = -1;
+                    break;
+                }
+                done += n;
+            }
+            pos += p->msg.sizes[i];
+        }
+        if (fd >= 0)
+            printf("[Thread %ld] Payload cache: memfd %zu bytes\n", pthread_self(), (size_t)pos);
+        p->memfd = fd;
+    }
+    int fd = p->memfd;
+    pthread_mutex_unlock(&payload_cache_lock);
+    return fd;
+}
+
+// Extra reference, e.g. for a transport whose sends outlive the connection's own.
+void payload_retain(payload_t *p) {
+    pthread_mutex_lock(&payload_cache_lock);
+    p->refs++;
+    pthread_mutex_unlock(&payload_cache_lock);
+}
+
+void payload_release(payload_t *p) {
+    if (!p) return;
+    pthread_mutex_lock(&payload_cache_lock);
+    p->refs--;
+    p->last_used = ++payload_clock;
+
+    // Keep idle payloads within budget, evicting the least recently used.
+    while (1) {
+        size_t idle = 0;
+        payload_t **oldest = NULL;
+        for (payload_t **q = &payload_cache; *q; q = &(*q)->next) {
+            if ((*q)->refs > 0) continue;
+            idle += (*q)->msg_size;
+            if (!oldest || (*q)->last_used < (*oldest)->last_used) oldest = q;
+        }
+        if (idle <= PAYLOAD_IDLE_BYTES || !oldest) break;
+        payload_t *victim = *oldest;
+        *oldest = victim->next;
+        payload_destroy(victim);
+    }
+    pthread_mutex_unlock(&payload_cache_lock);
+}
+
+#endif
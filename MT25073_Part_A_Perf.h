@@ -0,0 +1,164 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Perf.h
+ * Description: Per-thread hardware counters (server -P, client -P).
+ * `perf stat` around the whole process also counts accept(), setup and
+ * idle time, and needs root. Instead each worker opens its own counters
+ * with perf_event_open (this thread only, any CPU) and reads them around
+ * the transfer loop, so a connection is charged for exactly the work of
+ * sending (or receiving) its bytes:
+ *   cycles, instructions, L1D read misses, LLC misses, context switches
+ * The events form one group, read with a single read(), and are scaled by
+ * time_enabled / time_running if the PMU had to multiplex them.
+ * The kernel side of send() is where the copies happen, so kernel time is
+ * counted too; with kernel.perf_event_paranoid >= 2 only user space can be
+ * counted (reported as "user only"). Events the CPU or hypervisor does not
+ * offer are reported as n/a.
+ * Shared by the servers and the client.
+ */
+
+#ifndef MT25073_PART_A_PERF_H
+#define MT25073_PART_A_PERF_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define PERF_EV_CYCLES       0
+#define PERF_EV_INSTRUCTIONS 1
+#define PERF_EV_L1D_MISSES   2
+#define PERF_EV_LLC_MISSES   3
+#define PERF_EV_CS           4
+#define PERF_EV_COUNT        5
+
+const char *perf_event_names[PERF_EV_COUNT] = {
+    "cycles", "instructions", "L1D-misses", "LLC-misses", "cs"
+};
+
+typedef struct {
+    int leader;                  // Group leader fd (read() returns the whole group)
+    int fd[PERF_EV_COUNT];       // -1 = not available on this machine
+    int index[PERF_EV_COUNT];    // Position in the group read, -1 = not available
+    int nr;                      // Events in the group (0 = no counters at all)
+    int user_only;               // Kernel side could not be counted
+} perf_group_t;
+
+// Counts of one interval; value < 0 means "not available".
+typedef struct {
+    double v[PERF_EV_COUNT];
+} perf_sample_t;
+
+void perf_event_attr_for(struct perf_event_attr *attr, int event, int user_only) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->type = PERF_TYPE_HARDWARE;
+    switch (event) {
+    case PERF_EV_CYCLES:       attr->config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case PERF_EV_INSTRUCTIONS: attr->config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case PERF_EV_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_EV_LLC_MISSES:   attr->config = PERF_COUNT_HW_CACHE_MISSES; break;
+    default:
+        attr->type = PERF_TYPE_SOFTWARE;
+        attr->config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+        break;
+    }
+    attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                        PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr->exclude_kernel = user_only;
+    attr->exclude_hv = 1;
+}
+
+// Open the calling thread's counters and start them. Returns the number of
+// events that could be opened (0: no PMU access at all).
+int perf_group_open(perf_group_t *g) {
+    memset(g, 0, sizeof(*g));
+    g->leader = -1;
+    for (int e = 0; e < PERF_EV_COUNT; e++) g->fd[e] = g->index[e] = -1;
+
+    for (int e = 0; e < PERF_EV_COUNT; e++) {
+        struct perf_event_attr attr;
+        perf_event_attr_for(&attr, e, g->user_only);
+        attr.disabled = g->leader < 0; // The leader starts (and stops) the group
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, g->leader, 0);
+        if (fd < 0 && (errno == EACCES || errno == EPERM) && !g->user_only && g->leader < 0) {
+            // perf_event_paranoid forbids kernel counting: settle for user space
+            g->user_only = 1;
+            e--;
+            continue;
+        }
+        if (fd < 0) continue; // Not supported here
+        if (g->leader < 0) g->leader = fd;
+        g->fd[e] = fd;
+        g->index[e] = g->nr++;
+    }
+    if (g->leader >= 0) {
+        ioctl(g->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(g->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    return g->nr;
+}
+
+void perf_group_close(perf_group_t *g) {
+    if (g->nr == 0) return; // Never opened, or nothing to close
+    for (int e = 0; e < PERF_EV_COUNT; e++)
+        if (g->fd[e] >= 0) close(g->fd[e]);
+    memset(g, 0, sizeof(*g));
+    g->leader = -1;
+}
+
+// Current totals since perf_group_open(), scaled for multiplexing.
+void perf_group_read(const perf_group_t *g, perf_sample_t *s) {
+    // { nr, time_enabled, time_running, value[nr] }
+    uint64_t buf[3 + PERF_EV_COUNT];
+    for (int e = 0; e < PERF_EV_COUNT; e++) s->v[e] = -1;
+    if (g->nr == 0 || read(g->leader, buf, sizeof(buf)) < (ssize_t)(3 * sizeof(uint64_t))) return;
+    double scale = buf[2] ? (double)buf[1] / buf[2] : 0.0;
+    for (int e = 0; e < PERF_EV_COUNT; e++)
+        if (g->index[e] >= 0) s->v[e] = buf[3 + g->index[e]] * scale;
+}
+
+// acc += (after - before), for the events that are available.
+void perf_sample_add_delta(perf_sample_t *acc, const perf_sample_t *before,
+                           const perf_sample_t *after) {
+    for (int e = 0; e < PERF_EV_COUNT; e++) {
+        if (after->v[e] < 0) {
+            acc->v[e] = -1;
+            continue;
+        }
+        if (acc->v[e] < 0) acc->v[e] = 0;
+        acc->v[e] += after->v[e] - before->v[e];
+    }
+}
+
+// "cycles=N instructions=N ... bytes=N | 2.31 cycles/B, 0.85 IPC, 1.2 L1D-miss/KB, ..."
+// The raw counts are there for scripts, the ratios for people.
+void perf_sample_print(FILE *out, const char *prefix, const perf_sample_t *s, long long bytes,
+                       int user_only) {
+    fprintf(out, "%sPerf:", prefix);
+    for (int e = 0; e < PERF_EV_COUNT; e++) {
+        if (s->v[e] < 0) fprintf(out, " %s=n/a", perf_event_names[e]);
+        else fprintf(out, " %s=%.0f", perf_event_names[e], s->v[e]);
+    }
+    fprintf(out, " bytes=%lld |", bytes);
+    double kb = bytes / 1024.0;
+    if (s->v[PERF_EV_CYCLES] >= 0 && bytes > 0)
+        fprintf(out, " %.3f cycles/B,", s->v[PERF_EV_CYCLES] / bytes);
+    if (s->v[PERF_EV_CYCLES] > 0 && s->v[PERF_EV_INSTRUCTIONS] >= 0)
+        fprintf(out, " %.2f IPC,", s->v[PERF_EV_INSTRUCTIONS] / s->v[PERF_EV_CYCLES]);
+    if (s->v[PERF_EV_L1D_MISSES] >= 0 && bytes > 0)
+        fprintf(out, " %.2f L1D-miss/KB,", s->v[PERF_EV_L1D_MISSES] / kb);
+    if (s->v[PERF_EV_LLC_MISSES] >= 0 && bytes > 0)
+        fprintf(out, " %.3f LLC-miss/KB,", s->v[PERF_EV_LLC_MISSES] / kb);
+    fprintf(out, " %s\n", user_only ? "user only" : "user+kernel");
+}
+
+#endif
@@ -0,0 +1,1076 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Server.h
+ * Description: Shared server skeleton for PA02.
+ * Every server (A1/A2/A3) only differs in HOW it pushes one ComplexMessage
+ * onto the socket. That difference is captured in a transport_ops_t table;
+ * everything else (listening socket, handshake, accept loop, execution
+ * engine) lives here so all copy strategies run on the same engines.
+ *
+ * Engines:
+ *   default : one detached pthread per accepted client (blocking I/O).
+ *   -e N    : N event-loop threads, non-blocking sockets, edge-triggered epoll.
+ *   -w N    : N pre-spawned, optionally pinned workers with SO_REUSEPORT listeners.
+ * Transports with several flavours (A5) pick one with -m <variant>.
+ */
+
+#ifndef MT25073_PART_A_SERVER_H
+#define MT25073_PART_A_SERVER_H
+
+#include "MT25073_Part_A_Common.h"
+#include <pthread.h>
+#include <signal.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <limits.h>       // IOV_MAX
+#include <linux/filter.h> // Classic BPF for SO_ATTACH_REUSEPORT_CBPF
+#include <netinet/tcp.h>  // TCP_NODELAY
+#include <sys/prctl.h>    // PR_SET_TIMERSLACK
+#include <fcntl.h>        // F_GETPIPE_SZ
+#include "MT25073_Part_A_Arena.h"
+#include "MT25073_Part_A_Stitch.h"
+#include "MT25073_Part_A_Frame.h"
+#include "MT25073_Part_A_Pace.h"
+#include "MT25073_Part_A_Metrics.h"
+#include "MT25073_Part_A_Perf.h"
+
+volatile sig_atomic_t server_running = 1; // Global flag, = 0 to close the server
+
+struct transport_ops;
+struct payload;
+
+// Everything we know about one client connection.
+// The blocking engine keeps it on the worker's stack, the epoll engine on the heap.
+typedef struct connection {
+    int sock;                         // Where messages go: the socket, or an IPC_PIPE client's pipe
+    int ctrl;                         // Where the handshake and requests come from (== sock unless piped)
+    int ipc;                          // IPC_TCP / IPC_UNIX / IPC_PIPE
+    size_t msg_size;                  // Bytes per message on the wire (handshake size + frame header)
+    int duration_ms;                  // Measurement window (handshake)
+    int warmup_ms;                    // ... and the warmup before it
+    int pattern;                      // PATTERN_STREAM / PATTERN_PINGPONG (handshake)
+    unsigned long pending_requests;   // Ping-pong: requests not answered yet
+    unsigned max_batch;               // Messages a batching transport may send per call (0 = its default)
+    unsigned batch_k;                 // -k: messages per batch (MT25073_Part_A_Batch.h)
+    uint64_t batch_window_ns;         // -k auto: start of the current rate window
+    size_t batch_window_bytes;        // -k auto: total_bytes_sent at that point
+    int fields;                       // Fields per message (handshake)
+    int layout;                       // FIELDS_* (handshake)
+    int framed;                       // Frame header in front of every message (handshake)
+    size_t frame_hdr;                 // Its size: FRAME_HDR when framed, else 0
+    frame_header_t *frames;           // Framed: headers of the messages in flight (FRAME_RING)
+    int paced;                        // Open-loop stream: rate > 0 (handshake)
+    uint32_t rate;                    // ... messages per second
+    pace_t pace;                      // ... and their schedule (MT25073_Part_A_Pace.h)
+    uint64_t pace_start_ns;           // Schedule time 0 (CLOCK_MONOTONIC)
+    uint64_t pace_due_ns;             // The current message may not start before this
+    uint64_t pace_lag_max_ns;         // Latest start of a message relative to its schedule
+    perf_sample_t perf;               // -P: counters of this connection's transfer loop
+    tune_t tune;                      // Socket profile: server -T, overridden by the handshake
+    ComplexMessage msg;               // The strings we keep sending (shared, read-only)
+    struct payload *payload;          // Cache entry msg comes from (one reference)
+    size_t msg_offset;                // Bytes of the current message already sent (partial sends)
+    size_t total_bytes_sent;
+    unsigned long messages_sent;
+    run_clock_t clock;                // Warmup / measurement / done (MT25073_Part_A_Clock.h)
+    const struct transport_ops *ops;  // Copy strategy used for this connection
+    const char *variant;              // Its flavour (A5/A6): -m, or the strategy table entry
+    void *state;                      // Strategy private data (stitch buffer, iovecs, ...)
+
+    // --- Epoll engine bookkeeping (unused by the blocking engine) ---
+    int phase;                        // CONN_HANDSHAKE / CONN_SENDING / CONN_LINGER
+    uint64_t linger_until_ns;         // CONN_LINGER: stop waiting for completions then
+    unsigned char hs_buf[sizeof(handshake_t)];
+    size_t hs_len;                    // Handshake bytes received so far
+    unsigned char req_buf[sizeof(request_t)];
+    size_t req_len;                   // Bytes of a partially received ping-pong request
+    int in_ready;                     // Queued on the loop's ready list?
+    int retry_tick;                   // EAGAIN that no EPOLLOUT/EPOLLERR will end: retry on the sweep
+    int closing;                      // Closed while still queued, free when dequeued
+    int sleep_slot;                   // Paced: position in the loop's timer heap + 1 (0 = not in it)
+    struct connection *prev, *next;   // Loop's list of live connections
+    struct connection *ready_next;    // Loop's ready (writable) queue
+} connection_t;
+
+typedef struct {
+    int event_loops;                  // 0 = thread-per-connection, N = epoll engine with N loops
+    int shard;                        // Epoll: one SO_REUSEPORT listener per loop
+    int workers;                      // N = pre-spawned worker pool, one SO_REUSEPORT listener each
+    int align;                        // Steer connections to the listener of the receiving CPU
+    int cpus[MAX_PINNED_CPUS];        // Pin worker/loop i to cpus[i % cpu_count]
+    int cpu_count;                    // 0 = no pinning
+    const char *variant;              // Transport-specific flavour (-m), NULL = default
+    size_t mem_align;                 // -a: alignment of payload buffers
+    int huge_tlb;                     // -H: try MAP_HUGETLB for the arenas
+    int no_arena;                     // -M: plain malloc() per field (old behaviour)
+    const stitch_kernel_t *stitch_kernel; // -K: A1 copy kernel for large messages
+    size_t stitch_threshold;          // -N: messages from this size up use stitch_kernel
+    int batching;                     // -k given
+    unsigned batch;                   // -k: messages per batch, BATCH_AUTO = from -L
+    int batch_mode;                   // -B: BATCH_COALESCE / BATCH_MORE / BATCH_CORK
+    unsigned batch_budget_us;         // -L: latency budget for -k auto
+    const char *metrics_path;         // -s: shared-memory metrics file, NULL = off
+    int perf;                         // -P: per-thread hardware counters per connection
+    int ipc;                          // -i: IPC_TCP (PORT) or IPC_UNIX (unix_path)
+    char unix_path[UNIX_PATH_LEN];
+    tune_t tune;                      // -T: default socket profile (MT25073_Part_A_Tune.h)
+} server_config_t;
+
+server_config_t server_config;        // Filled by run_server(), read by the transports
+
+// One copy strategy. send_message() pushes bytes [msg_offset, msg_size) of
+// the current message and returns what the syscall returned:
+//   > 0 : bytes accepted by the kernel (may be a partial send)
+//     0 : nothing sent, but try again (e.g. A3 drained a full error queue)
+//    -1 : error, errno set (EAGAIN means "wait for EPOLLOUT" in epoll mode)
+typedef struct transport_ops {
+    const char *name;                                  // e.g. "A2 One-Copy"
+    int (*setup)(connection_t *conn);                  // After handshake. 0 on success
+    ssize_t (*send_message)(connection_t *conn, int flags);
+    void (*on_error_queue)(connection_t *conn);        // Optional: drain MSG_ERRQUEUE
+    void (*teardown)(connection_t *conn);              // Free whatever setup() allocated
+    unsigned (*in_flight)(connection_t *conn);         // Optional: sends the kernel still holds
+    int blocking_only;                                 // Cannot run on the epoll engine
+    int (*check_config)(const server_config_t *cfg);   // Optional: validate -m etc. at startup
+} transport_ops_t;
+
+// Strategy table of the unified server: TRANSPORT_* id -> transport.
+// Single-transport servers leave transport_table NULL.
+typedef struct {
+    int id;                           // TRANSPORT_*
+    const transport_ops_t *ops;
+    const char *variant;              // Flavour passed to the transport (NULL = its default)
+} transport_entry_t;
+
+const transport_entry_t *transport_table = NULL;
+int transport_table_len = 0;
+
+#define CONN_HANDSHAKE 0
+#define CONN_SENDING   1
+#define CONN_LINGER    2 // Done sending, waiting for zero-copy completions (epoll engine)
+
+// --- Helper: read exactly len bytes (recv() may return less on a stream socket) ---
+int recv_all(int sock, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(sock, (char *)buf + got, len - got, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1; // Client disconnected or error
+        got += n;
+    }
+    return 0;
+}
+
+// --- Helper: send()/sendmsg() that also work on an IPC_PIPE client's pipe ---
+// A pipe takes no flags: MSG_MORE has nothing to hold back there.
+ssize_t conn_send(connection_t *conn, const void *buf, size_t len, int flags) {
+    if (conn->ipc == IPC_PIPE) return write(conn->sock, buf, len);
+    return send(conn->sock, buf, len, flags);
+}
+
+ssize_t conn_sendmsg(connection_t *conn, const struct msghdr *msg, int flags) {
+    if (conn->ipc == IPC_PIPE) return writev(conn->sock, msg->msg_iov, msg->msg_iovlen);
+    return sendmsg(conn->sock, msg, flags);
+}
+
+// --- Helper: account for bytes the kernel accepted ---
+// When the whole message is out, rewind to the start of the next one.
+// A batching transport (A4) may report several messages in one call.
+void record_progress(connection_t *conn, size_t sent) {
+    conn->msg_offset += sent;
+    conn->total_bytes_sent += sent;
+    metrics_add(METRIC_BYTES, sent);
+    if (conn->msg_offset >= conn->msg_size) {
+        conn->messages_sent += conn->msg_offset / conn->msg_size;
+        metrics_add(METRIC_MESSAGES, conn->msg_offset / conn->msg_size);
+        conn->msg_offset %= conn->msg_size;
+    }
+}
+
+// --- Helper: describe the unsent tail of a message as an iovec list ---
+// Fields that were fully sent are skipped, the first remaining field is trimmed.
+// The kernel takes at most IOV_MAX entries per call, so a message with more
+// fields goes out in chunks: at most `max` entries are filled, and *more is
+// set when fields are left for a later call (callers add MSG_MORE then).
+// Returns the number of iovec entries filled.
+int build_iov_from_offset(const ComplexMessage *msg, size_t offset, struct iovec *iov,
+                          int max, int *more) {
+    int count = 0;
+    int i = 0;
+    for (; i < msg->count && count < max; i++) {
+        if (offset >= msg->sizes[i]) {
+            offset -= msg->sizes[i];
+            continue;
+        }
+        iov[count].iov_base = msg->fields[i] + offset;
+        iov[count].iov_len = msg->sizes[i] - offset;
+        offset = 0;
+        count++;
+    }
+    if (more) *more = i < msg->count;
+    return count;
+}
+
+// Same for batching: the unsent tail of this message followed by
+// `messages` - 1 whole ones. *more is set if the batch did not fit in `max`.
+int build_iov_batch(const ComplexMessage *msg, size_t offset, unsigned messages,
+                    struct iovec *iov, int max, int *more) {
+    int count = 0, cut = 0;
+    unsigned m = 0;
+    for (; m < messages && count < max; m++) {
+        count += build_iov_from_offset(msg, m == 0 ? offset : 0, iov + count, max - count, &cut);
+        if (cut) break;
+    }
+    if (more) *more = cut || m < messages;
+    return count;
+}
+
+// --- Helper: handshake payload -> connection fields ---
+// Returns -1 for requests we cannot serve.
+int apply_handshake(connection_t *conn, const unsigned char *buf) {
+    handshake_t hs;
+    memcpy(&hs, buf, sizeof(hs));
+    conn->msg_size = hs.msg_size;
+    conn->duration_ms = hs.duration_ms;
+    conn->warmup_ms = hs.warmup_ms;
+    conn->pattern = hs.pattern;
+    conn->fields = hs.fields ? hs.fields : MSG_DEFAULT_FIELDS;
+    conn->layout = hs.layout;
+    conn->framed = hs.framing;
+    conn->rate = hs.rate;
+    conn->paced = hs.rate > 0 && hs.pattern == PATTERN_STREAM;
+    conn->variant = server_config.variant;
+    conn->tune = server_config.tune;
+    tune_merge(&conn->tune, &hs.tune);
+    // The listener decides between TCP and Unix; the client only says whether a pipe follows.
+    conn->ipc = hs.ipc == IPC_PIPE ? IPC_PIPE : server_config.ipc;
+    if (conn->msg_size == 0 || conn->duration_ms < 0 || conn->warmup_ms < 0) return -1;
+    // Same window as the client: it started the run before connecting.
+    run_clock_init(&conn->clock, run_agreed_start(hs.run_start_ns, hs.warmup_ms, hs.duration_ms),
+                   hs.warmup_ms, hs.duration_ms);
+    if (conn->ipc == IPC_PIPE && (server_config.ipc != IPC_UNIX || server_config.event_loops > 0)) {
+        fprintf(stderr, "Pipe clients need a Unix socket listener (-i unix) and a blocking engine\n");
+        return -1;
+    }
+    if (conn->pattern != PATTERN_STREAM && conn->pattern != PATTERN_PINGPONG) return -1;
+    if (conn->framed != FRAMING_OFF && conn->framed != FRAMING_ON) return -1;
+    if (conn->paced && (hs.arrivals < 0 || hs.arrivals >= ARRIVALS_COUNT)) return -1;
+    if (conn->paced) {
+        // The schedule starts when the client sent the handshake, so accepting
+        // and setting up the connection already count as lateness. The
+        // client's clock is ours on the same host; a start that makes no
+        // sense on our clock (another host) is replaced by "now".
+        pace_init(&conn->pace, hs.rate, hs.arrivals, hs.seed);
+        uint64_t now = run_now_ns();
+        conn->pace_start_ns = (hs.start_ns <= now && now - hs.start_ns < PACE_MAX_SKEW_NS)
+                                  ? hs.start_ns : now;
+        conn->pace_due_ns = conn->pace_start_ns + pace_next(&conn->pace);
+        conn->pace_lag_max_ns = 0;
+    }
+    if (conn->fields < 1 || conn->fields > MSG_MAX_FIELDS || (size_t)conn->fields > conn->msg_size ||
+        conn->layout < 0 || conn->layout >= FIELDS_LAYOUT_COUNT) {
+        fprintf(stderr, "Client asked for %d fields (layout %d) in %zu bytes\n",
+                conn->fields, conn->layout, conn->msg_size);
+        return -1;
+    }
+
+    // The client may pick the transport; only a server with a table can honour that.
+    if (hs.transport != TRANSPORT_DEFAULT) {
+        const transport_entry_t *entry = NULL;
+        for (int i = 0; i < transport_table_len; i++)
+            if (transport_table[i].id == hs.transport) entry = &transport_table[i];
+        if (!entry) {
+            fprintf(stderr, "Client asked for transport %d, which this server does not offer\n",
+                    hs.transport);
+            return -1;
+        }
+        conn->ops = entry->ops;
+        conn->variant = entry->variant;
+    }
+    if (conn->ops->blocking_only && server_config.event_loops > 0) {
+        fprintf(stderr, "%s cannot run on the epoll engine\n", conn->ops->name);
+        return -1;
+    }
+
+    // A reply is exactly one message, so batching transports must not run ahead;
+    // neither may a paced stream, whose messages each have their own send time.
+    conn->max_batch = (conn->pattern == PATTERN_PINGPONG || conn->paced) ? 1 : 0;
+    return 0;
+}
+
+const char *pattern_name(int pattern) {
+    return pattern == PATTERN_PINGPONG ? "ping-pong" : "stream";
+}
+
+// --- Helper: arena for a transport's extra buffers (count messages' worth) ---
+// Leaves arena->base NULL (= use malloc) when arenas are disabled or mmap fails.
+void create_payload_arena(arena_t *arena, size_t msg_size, int fields, int count) {
+    memset(arena, 0, sizeof(*arena));
+    if (server_config.no_arena) return;
+    size_t align = server_config.mem_align;
+    if (arena_create(arena, arena_capacity_for(msg_size, fields, count, align), align,
+                     server_config.huge_tlb) != 0)
+        perror("arena mmap (falling back to malloc)");
+}
+
+#include "MT25073_Part_A_Payload.h"
+#include "MT25073_Part_A_Batch.h"
+
+// --- Framing helpers (MT25073_Part_A_Frame.h) ---
+// A transport may still be sending a header after the connection moved on
+// (MSG_ZEROCOPY, io_uring), so the header of message `seq` lives in slot
+// seq % FRAME_RING and is only rewritten FRAME_RING messages later.
+// A3 and A4 keep the messages they have in flight below that.
+#define FRAME_RING 4096
+
+frame_header_t *frame_for(connection_t *conn, unsigned long seq) {
+    frame_header_t *h = &conn->frames[seq % FRAME_RING];
+    h->magic = FRAME_MAGIC;
+    h->crc32c = conn->payload->crc;
+    h->seq = seq;
+    h->length = conn->msg_size - conn->frame_hdr;
+    return h;
+}
+
+// build_iov_batch() for a connection: with framing, every message starts
+// with an iovec for its header, followed by the payload fields.
+int build_iov_conn(connection_t *conn, unsigned messages, struct iovec *iov, int max,
+                   int *more) {
+    if (!conn->frame_hdr)
+        return build_iov_batch(&conn->msg, conn->msg_offset, messages, iov, max, more);
+
+    int count = 0, cut = 0;
+    unsigned m = 0;
+    size_t offset = conn->msg_offset;
+    for (; m < messages && count < max; m++, offset = 0) {
+        if (offset < conn->frame_hdr) {
+            iov[count].iov_base = (char *)frame_for(conn, conn->messages_sent + m) + offset;
+            iov[count].iov_len = conn->frame_hdr - offset;
+            count++;
+            offset = 0;
+            if (count == max) {
+                cut = 1;
+                break;
+            }
+        } else {
+            offset -= conn->frame_hdr;
+        }
+        count += build_iov_from_offset(&conn->msg, offset, iov + count, max - count, &cut);
+        if (cut) break;
+    }
+    if (more) *more = cut || m < messages;
+    return count;
+}
+
+// --- Open-loop pacing (MT25073_Part_A_Pace.h) ---
+// The schedule starts at the handshake (apply_handshake()); a message is
+// started no earlier than its due time, and back to back when behind.
+// Sleeps of a pacing thread end on time instead of up to 50 us late
+// (the default timer slack, which would delay every paced message).
+void pace_tight_timers(void) {
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+}
+
+// Nanoseconds until the next send may happen (0 = now).
+uint64_t pace_wait_ns(connection_t *conn) {
+    if (!conn->paced || conn->msg_offset != 0) return 0; // Never pause inside a message
+    uint64_t now = run_now_ns();
+    if (now < conn->pace_due_ns) return conn->pace_due_ns - now;
+    if (now - conn->pace_due_ns > conn->pace_lag_max_ns) conn->pace_lag_max_ns = now - conn->pace_due_ns;
+    return 0;
+}
+
+// After record_progress(): every completed message moves the schedule on.
+void pace_progress(connection_t *conn, unsigned long messages_before) {
+    if (!conn->paced) return;
+    for (unsigned long m = messages_before; m < conn->messages_sent; m++)
+        conn->pace_due_ns = conn->pace_start_ns + pace_next(&conn->pace);
+}
+
+void pace_report(const connection_t *conn, const char *who, long id) {
+    if (!conn->paced) return;
+    printf("[%s %ld] Open loop: %u msg/s (%s), %lu messages, max start lag %.1f us\n",
+           who, id, conn->rate, arrival_names[conn->pace.arrivals], conn->messages_sent,
+           conn->pace_lag_max_ns / 1e3);
+}
+
+// --- Hardware counters per connection (-P, MT25073_Part_A_Perf.h) ---
+// Each worker thread owns one counter group; the work it does for a
+// connection is the difference of two reads around that work.
+__thread perf_group_t perf_thread;
+
+void perf_thread_open(void) {
+    if (server_config.perf) perf_group_open(&perf_thread);
+}
+
+void perf_thread_close(void) {
+    perf_group_close(&perf_thread);
+}
+
+void perf_begin(perf_sample_t *mark) {
+    if (server_config.perf) perf_group_read(&perf_thread, mark);
+}
+
+void perf_end(connection_t *conn, const perf_sample_t *mark) {
+    if (!server_config.perf) return;
+    perf_sample_t now;
+    perf_group_read(&perf_thread, &now);
+    perf_sample_add_delta(&conn->perf, mark, &now);
+}
+
+void perf_report(const connection_t *conn, const char *who, long id) {
+    if (!server_config.perf) return;
+    char prefix[48];
+    snprintf(prefix, sizeof(prefix), "[%s %ld] ", who, id);
+    perf_sample_print(stdout, prefix, &conn->perf, conn->total_bytes_sent, perf_thread.user_only);
+}
+
+// --- Helper: attach the shared message and let the strategy allocate its buffers ---
+int prepare_connection(connection_t *conn) {
+    conn->payload = payload_acquire(conn->msg_size, conn->fields, conn->layout);
+    if (!conn->payload) return -1;
+    conn->msg = conn->payload->msg; // Transports only ever read the fields
+    conn->msg_offset = 0;
+    conn->total_bytes_sent = 0;
+    conn->messages_sent = 0;
+    conn->frame_hdr = 0;
+    conn->frames = NULL;
+    if (conn->framed) {
+        // From here on msg_size counts the header too: every byte-counting
+        // helper (record_progress, batching, partial sends) sees wire messages.
+        conn->frames = malloc(FRAME_RING * sizeof(frame_header_t));
+        if (!conn->frames) {
+            payload_release(conn->payload);
+            conn->payload = NULL;
+            return -1;
+        }
+        conn->frame_hdr = FRAME_HDR;
+        conn->msg_size += FRAME_HDR;
+    }
+    if (conn->ops->setup && conn->ops->setup(conn) != 0) {
+        payload_release(conn->payload);
+        conn->payload = NULL;
+        free(conn->frames);
+        conn->frames = NULL;
+        return -1;
+    }
+    // Request/response and paced traffic is latency-bound: don't let Nagle
+    // hold back replies or messages that are due.
+    if (conn->pattern == PATTERN_PINGPONG || conn->paced) {
+        int one = 1;
+        setsockopt(conn->sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    // The socket profile comes last, so an explicit nodelay=0 wins.
+    // A pipe has only its size (the client chose it).
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "[Thread %ld] ", (long)pthread_self());
+    if (conn->ipc == IPC_PIPE) {
+        printf("%sPipe: size=%d\n", prefix, fcntl(conn->sock, F_GETPIPE_SZ));
+    } else {
+        uint32_t refused = tune_apply(conn->sock, &conn->tune, conn->ipc == IPC_TCP);
+        tune_report(stdout, prefix, conn->sock, conn->ipc == IPC_TCP, refused);
+    }
+    batch_start(conn);
+    metrics_add(METRIC_CONNECTIONS, 1);
+    return 0;
+}
+
+// --- Ping-pong helper: send exactly one complete message (blocking engine) ---
+int send_one_message(connection_t *conn) {
+    unsigned long target = conn->messages_sent + 1;
+    while (conn->messages_sent < target) {
+        ssize_t sent = conn->ops->send_message(conn, 0);
+        metrics_add(METRIC_SYSCALLS, 1);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        record_progress(conn, sent);
+    }
+    return 0;
+}
+
+// IPC_PIPE: the client passes the write end of its pipe right after the
+// handshake. From then on every transport writes to the pipe (conn->sock),
+// while ping-pong requests still arrive on the socket (conn->ctrl).
+int attach_pipe(connection_t *conn) {
+    int fd = recv_fd(conn->ctrl);
+    if (fd < 0) {
+        fprintf(stderr, "Client announced a pipe but did not send one\n");
+        return -1;
+    }
+    conn->sock = fd;
+    return 0;
+}
+
+void close_connection_fds(connection_t *conn) {
+    if (conn->ctrl != conn->sock) close(conn->ctrl);
+    close(conn->sock);
+}
+
+void release_connection(connection_t *conn) {
+    if (conn->ops->teardown) conn->ops->teardown(conn);
+    payload_release(conn->payload);
+    conn->payload = NULL;
+    free(conn->frames);
+    conn->frames = NULL;
+    close_connection_fds(conn);
+}
+
+// CPU for worker/loop `index`, or -1 when pinning was not requested.
+int worker_cpu(const server_config_t *cfg, int index) {
+    if (cfg->cpu_count == 0) return -1;
+    return cfg->cpus[index % cfg->cpu_count];
+}
+
+#include "MT25073_Part_A_Epoll.h"
+
+// ---------------------------------------------------------------------
+// Engine 1: Thread-per-connection (blocking)
+// ---------------------------------------------------------------------
+
+typedef struct {
+    int client_socket;
+    const transport_ops_t *ops;
+} thread_args_t;   // To pass socket Id in thread, we wrap it in a struct
+
+// Serve one client on the calling thread until its measurement window ends.
+// Shared by the thread-per-connection engine and the worker pool.
+void serve_client(int sock, const transport_ops_t *ops) {
+    connection_t conn;
+    memset(&conn, 0, sizeof(conn));
+    conn.sock = conn.ctrl = sock;
+    conn.ops = ops;
+
+    // 1. PROTOCOL HANDSHAKE: handshake_t (size, duration, pattern, ...)
+    unsigned char hs[sizeof(handshake_t)];
+    if (recv_all(conn.ctrl, hs, sizeof(hs)) < 0 || apply_handshake(&conn, hs) < 0 ||
+        (conn.ipc == IPC_PIPE && attach_pipe(&conn) < 0)) {
+        close_connection_fds(&conn); // Client disconnected or sent garbage, clean up and die.
+        return;
+    }
+
+    printf("[Thread %ld] %s: Size=%zu, Fields=%d (%s), Duration=%d ms (+%d ms warmup), Pattern=%s%s%s\n",
+           pthread_self(), conn.ops->name, conn.msg_size, conn.fields, layout_names[conn.layout],
+           conn.duration_ms, conn.warmup_ms, pattern_name(conn.pattern), conn.framed ? ", framed" : "",
+           conn.ipc == IPC_PIPE ? ", pipe" : "");
+
+    // 2. PREPARE THE DATA (the strings + strategy buffers)
+    if (prepare_connection(&conn) != 0) {
+        close_connection_fds(&conn);
+        return;
+    }
+
+    if (conn.paced) pace_tight_timers();
+    perf_sample_t perf_mark;
+    perf_begin(&perf_mark);
+
+    // 3. THE MAIN TRANSFER LOOP
+    // Run until the measurement window ends. Partial sends are resumed
+    // from msg_offset, so message boundaries stay aligned on the wire.
+    while (run_tick(&conn.clock, conn.total_bytes_sent) != RUN_DONE) {
+        if (conn.pattern == PATTERN_PINGPONG) {
+            // Wait for the next request, answer with one full message.
+            request_t req;
+            if (recv_all(conn.ctrl, &req, sizeof(req)) < 0) break;
+            if (send_one_message(&conn) < 0) break;
+            continue;
+        }
+
+        // Open loop: sleep until the next message is due.
+        uint64_t wait = pace_wait_ns(&conn);
+        if (wait > 0) {
+            struct timespec ts = { (time_t)(wait / 1000000000ULL), (long)(wait % 1000000000ULL) };
+            nanosleep(&ts, NULL);
+            continue;
+        }
+
+        ssize_t sent = conn.ops->send_message(&conn, batch_send_flags(&conn));
+        metrics_add(METRIC_SYSCALLS, 1);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            break; // Network error, stop.
+        }
+        unsigned long before = conn.messages_sent;
+        record_progress(&conn, sent);
+        batch_progress(&conn, before);
+        pace_progress(&conn, before);
+    }
+    perf_end(&conn, &perf_mark);
+
+    // 4. CLEANUP
+    if (conn.ops->on_error_queue) conn.ops->on_error_queue(&conn);
+    printf("[Thread %ld] Finished. Sent %zu bytes (%llu in the measurement window).\n",
+           pthread_self(), conn.total_bytes_sent,
+           (unsigned long long)run_window_bytes(&conn.clock, conn.total_bytes_sent));
+    pace_report(&conn, "Thread", (long)pthread_self());
+    perf_report(&conn, "Thread", (long)pthread_self());
+    release_connection(&conn);
+}
+
+// The "Worker" function: one thread serves one client.
+void *handle_client(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    int sock = args->client_socket;
+    const transport_ops_t *ops = args->ops;
+    free(args); // We don't need the container anymore
+
+    metrics_claim("thread");
+    perf_thread_open();
+    serve_client(sock, ops);
+    perf_thread_close();
+    metrics_release();
+    return NULL;
+}
+
+void accept_loop(int server_fd, const transport_ops_t *ops) {
+    while (server_running) {
+        // accept() BLOCKS until a client connects.
+        int new_socket = accept(server_fd, NULL, NULL);
+        if (new_socket < 0) {
+            if (errno != EINTR) perror("accept");
+            continue;
+        }
+
+        thread_args_t *args = malloc(sizeof(thread_args_t));
+        args->client_socket = new_socket;
+        args->ops = ops;
+
+        // SPAWN THREAD, detached so the OS cleans it up when it returns.
+        pthread_t thread_id;
+        if (pthread_create(&thread_id, NULL, handle_client, (void *)args) != 0) {
+            perror("pthread_create");
+            free(args);
+            close(new_socket);
+        } else {
+            pthread_detach(thread_id);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------
+// Engine 2: Pre-spawned, pinned worker pool (-w N)
+// ---------------------------------------------------------------------
+// Every worker owns a SO_REUSEPORT listener, so the kernel spreads incoming
+// connections across workers and no thread is created per connection.
+// A worker serves its clients one after another on its own CPU.
+
+typedef struct {
+    int id;
+    int listen_fd;
+    int cpu;                     // -1 = let the scheduler decide
+    const transport_ops_t *ops;
+} pool_worker_t;
+
+void *pool_worker_thread(void *arg) {
+    pool_worker_t *w = (pool_worker_t *)arg;
+    if (w->cpu >= 0) pin_thread_to_cpu(w->cpu);
+    char role[20];
+    snprintf(role, sizeof(role), "worker %d", w->id);
+    metrics_claim(role);
+    perf_thread_open();
+
+    while (server_running) {
+        int sock = accept(w->listen_fd, NULL, NULL);
+        if (sock < 0) {
+            if (errno != EINTR) perror("accept");
+            continue;
+        }
+        serve_client(sock, w->ops);
+    }
+    perf_thread_close();
+    metrics_release();
+    return NULL;
+}
+
+void run_worker_pool(const int *listen_fds, const transport_ops_t *ops, const server_config_t *cfg) {
+    pool_worker_t *workers = calloc(cfg->workers, sizeof(pool_worker_t));
+    pthread_t *threads = calloc(cfg->workers, sizeof(pthread_t));
+
+    for (int i = 0; i < cfg->workers; i++) {
+        workers[i].id = i;
+        workers[i].listen_fd = listen_fds[i];
+        workers[i].cpu = worker_cpu(cfg, i);
+        workers[i].ops = ops;
+        if (pthread_create(&threads[i], NULL, pool_worker_thread, &workers[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < cfg->workers; i++) pthread_join(threads[i], NULL);
+    free(threads);
+    free(workers);
+}
+
+// ---------------------------------------------------------------------
+// Setup shared by all engines
+// ---------------------------------------------------------------------
+
+// -i unix: a Unix domain stream socket at cfg->unix_path. A stale socket
+// file from an earlier run is removed first.
+int create_unix_listener(const server_config_t *cfg) {
+    struct sockaddr_un address;
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd < 0) {
+        perror("socket failed");
+        exit(EXIT_FAILURE);
+    }
+    unix_address(&address, cfg->unix_path);
+    unlink(cfg->unix_path);
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        perror("bind failed");
+        exit(EXIT_FAILURE);
+    }
+    if (listen(server_fd, SOMAXCONN) < 0) {
+        perror("listen");
+        exit(EXIT_FAILURE);
+    }
+    return server_fd;
+}
+
+int create_listener(int reuseport) {
+    int server_fd;
+    struct sockaddr_in address;
+    int opt = 1;
+
+    // 1. CREATE SOCKET (AF_INET = IPv4, SOCK_STREAM = TCP)
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        perror("socket failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // 2. SO_REUSEADDR lets us restart immediately without waiting for TIME_WAIT.
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
+        perror("setsockopt");
+        exit(EXIT_FAILURE);
+    }
+    // SO_REUSEPORT lets several listeners bind the same port; the kernel
+    // load-balances new connections between them.
+    if (reuseport && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) {
+        perror("setsockopt SO_REUSEPORT");
+        exit(EXIT_FAILURE);
+    }
+
+    // 3. DEFINE ADDRESS + BIND
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(PORT);
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        perror("bind failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // 4. LISTEN. The epoll engine can accept thousands of clients, so the
+    // backlog is sized for bursts of connects rather than a handful of threads.
+    if (listen(server_fd, SOMAXCONN) < 0) {
+        perror("listen");
+        exit(EXIT_FAILURE);
+    }
+    return server_fd;
+}
+
+// --- Align listeners with CPUs (-A) ---
+// A classic BPF program picks the listener for each new connection:
+// index = (CPU that processed the SYN) % listeners. On loopback that is the
+// client thread's CPU, on a NIC it is the CPU servicing the RX queue's IRQ.
+// With worker i pinned to CPU i, a connection is served where it arrived.
+int attach_cpu_steering(int listen_fd, int listeners) {
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU }, // A = current CPU
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (unsigned)listeners },    // A = A % listeners
+        { BPF_RET | BPF_A, 0, 0, 0 },                                // return A
+    };
+    struct sock_fprog prog = { .len = sizeof(code) / sizeof(code[0]), .filter = code };
+    if (setsockopt(listen_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        perror("setsockopt SO_ATTACH_REUSEPORT_CBPF");
+        return -1;
+    }
+    return 0;
+}
+
+// One listener per worker/loop when sharding, otherwise a single shared one.
+// Sharded listeners join the reuseport group in index order, which is the
+// order the steering program's return value refers to.
+int *open_listeners(const server_config_t *cfg, int *count) {
+    int threads = cfg->workers ? cfg->workers : cfg->event_loops;
+    int sharded = cfg->workers > 0 || cfg->shard;
+    *count = sharded ? threads : 1;
+
+    int *fds = calloc(*count, sizeof(int));
+    if (cfg->ipc == IPC_UNIX) {
+        // Unix sockets have no SO_REUSEPORT: the workers/loops share one
+        // listener (each gets its own descriptor of it).
+        fds[0] = create_unix_listener(cfg);
+        for (int i = 1; i < *count; i++) fds[i] = dup(fds[0]);
+        return fds;
+    }
+    for (int i = 0; i < *count; i++) fds[i] = create_listener(sharded);
+    if (cfg->align && attach_cpu_steering(fds[0], *count) < 0) exit(EXIT_FAILURE);
+    return fds;
+}
+
+void print_server_usage(const char *prog) {
+    printf("Usage: %s [-e <event loops> [-r]] [-w <workers>] [-c <cpu list>] [-A] [-m <variant>] [-a <align>] [-H] [-M] [-K <kernel>] [-N <bytes>]\n"
+           "       [-k <K|auto>] [-B <mode>] [-L <us>] [-s <file>|off] [-P] [-i tcp|unix[:path]] [-T <profile>]\n", prog);
+    printf("  -e N  Serve clients from N epoll event-loop threads (non-blocking, edge-triggered)\n");
+    printf("  -r    With -e: give every loop its own SO_REUSEPORT listener\n");
+    printf("  -w N  Pre-spawned pool of N workers, each with its own SO_REUSEPORT listener\n");
+    printf("        Default (neither -e nor -w): one thread per connection\n");
+    printf("  -c L  Pin workers/loops to CPUs, e.g. 0-3 or 0,2,4,6 (worker i -> i-th CPU)\n");
+    printf("  -A    Steer each connection to the listener of the CPU that received it\n");
+    printf("        (pair with pinned client threads or per-queue RX IRQ affinity)\n");
+    printf("  -m V  Transport variant (A5: sendfile | splice | vmsplice, A6: static[:T1,T2] | online)\n");
+    printf("  -a N  Align payload buffers to N bytes (power of two, default %d)\n", ARENA_DEFAULT_ALIGN);
+    printf("  -H    Back payload arenas with reserved huge pages (MAP_HUGETLB), else THP\n");
+    printf("  -M    No arena: malloc() every field separately\n");
+    printf("  -K K  A1 stitching kernel for large messages: memcpy | sse2 | avx2 | avx512\n");
+    printf("        (default: widest the CPU supports, streaming stores)\n");
+    printf("  -N B  Stitch messages of B bytes and more with -K, smaller ones with memcpy\n");
+    printf("        (default: half the last-level cache, %zu here)\n", stitch_llc_size() / 2);
+    printf("  -k K  Send K messages per batch (1-%d), or 'auto' to size K from -L\n", BATCH_MAX);
+    printf("  -B M  Batching: coalesce (K messages per syscall, default) | more (MSG_MORE) |\n"
+           "        cork (TCP_CORK, uncorked every K messages)\n");
+    printf("  -L us Latency budget for -k auto (default %d us)\n", BATCH_DEFAULT_BUDGET_US);
+    printf("  -P    Count cycles, instructions, L1D/LLC misses and context switches of every\n"
+           "        connection's transfer loop (perf_event_open, no root needed)\n");
+    printf("  -s F  Live metrics in shared-memory file F (default %s), 'off' to disable;\n"
+           "        watch with ./metrics_top\n", METRICS_PATH);
+    printf("  -i I  Listen on TCP port %d (tcp, default) or a Unix socket (unix, default path\n"
+           "        %s); Unix socket clients may also ask for a pipe (client -i pipe)\n",
+           PORT, UNIX_SOCKET_PATH);
+    printf("  -T P  Socket profile for every connection; the client's -T overrides it per setting:\n"
+           "        sndbuf=N rcvbuf=N nodelay=0|1 lowat=N busypoll=us preferbusy=0|1 pacing=B/s\n"
+           "        (K/M/G suffixes), or the presets throughput | latency, comma-separated\n");
+}
+
+int parse_server_args(int argc, char *argv[], server_config_t *cfg) {
+    int c;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mem_align = ARENA_DEFAULT_ALIGN;
+    cfg->stitch_kernel = stitch_kernel_find(NULL);
+    cfg->stitch_threshold = stitch_llc_size() / 2;
+    cfg->batch_mode = BATCH_COALESCE;
+    cfg->batch_budget_us = BATCH_DEFAULT_BUDGET_US;
+    cfg->metrics_path = METRICS_PATH;
+    cfg->ipc = IPC_TCP;
+    while ((c = getopt(argc, argv, "e:rw:c:Am:a:HMK:N:k:B:L:s:Pi:T:h")) != -1) {
+        switch (c) {
+        case 'e':
+            cfg->event_loops = atoi(optarg);
+            if (cfg->event_loops <= 0) {
+                fprintf(stderr, "Event loop count must be positive\n");
+                return -1;
+            }
+            break;
+        case 'r':
+            cfg->shard = 1;
+            break;
+        case 'w':
+            cfg->workers = atoi(optarg);
+            if (cfg->workers <= 0) {
+                fprintf(stderr, "Worker count must be positive\n");
+                return -1;
+            }
+            break;
+        case 'c':
+            cfg->cpu_count = parse_cpu_list(optarg, cfg->cpus, MAX_PINNED_CPUS);
+            if (cfg->cpu_count <= 0) {
+                fprintf(stderr, "Invalid CPU list '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        case 'A':
+            cfg->align = 1;
+            break;
+        case 'm':
+            cfg->variant = optarg;
+            break;
+        case 'a': {
+            long a = atol(optarg);
+            if (a < 8 || (a & (a - 1)) != 0) {
+                fprintf(stderr, "Alignment must be a power of two >= 8\n");
+                return -1;
+            }
+            cfg->mem_align = (size_t)a;
+            break;
+        }
+        case 'H':
+            cfg->huge_tlb = 1;
+            break;
+        case 'M':
+            cfg->no_arena = 1;
+            break;
+        case 'K':
+            cfg->stitch_kernel = stitch_kernel_find(optarg);
+            if (!cfg->stitch_kernel) {
+                fprintf(stderr, "Stitching kernel '%s' is unknown or not supported by this CPU\n", optarg);
+                return -1;
+            }
+            break;
+        case 'N': {
+            char *end;
+            cfg->stitch_threshold = strtoull(optarg, &end, 10);
+            if (end == optarg || *end != '\0') {
+                fprintf(stderr, "Invalid stitching threshold '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        }
+        case 'k':
+            cfg->batching = 1;
+            if (strcmp(optarg, "auto") == 0) {
+                cfg->batch = BATCH_AUTO;
+                break;
+            }
+            cfg->batch = (unsigned)atoi(optarg);
+            if (cfg->batch < 1 || cfg->batch > BATCH_MAX) {
+                fprintf(stderr, "Batch size must be 1-%d or 'auto'\n", BATCH_MAX);
+                return -1;
+            }
+            break;
+        case 'B':
+            cfg->batch_mode = batch_mode_id(optarg);
+            if (cfg->batch_mode < 0) {
+                fprintf(stderr, "Unknown batching mode '%s' (coalesce | more | cork)\n", optarg);
+                return -1;
+            }
+            break;
+        case 'L':
+            cfg->batch_budget_us = (unsigned)atoi(optarg);
+            if (cfg->batch_budget_us == 0) {
+                fprintf(stderr, "Latency budget must be positive\n");
+                return -1;
+            }
+            break;
+        case 'P':
+            cfg->perf = 1;
+            break;
+        case 's':
+            cfg->metrics_path = strcmp(optarg, "off") == 0 ? NULL : optarg;
+            break;
+        case 'i':
+            cfg->ipc = parse_ipc(optarg, cfg->unix_path);
+            if (cfg->ipc != IPC_TCP && cfg->ipc != IPC_UNIX) {
+                fprintf(stderr, "Invalid listener '%s' (tcp | unix[:path])\n", optarg);
+                return -1;
+            }
+            break;
+        case 'T':
+            if (tune_parse(optarg, &cfg->tune) != 0) {
+                fprintf(stderr, "Invalid socket profile '%s'\n", optarg);
+                return -1;
+            }
+            break;
+        default:
+            print_server_usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (cfg->workers && cfg->event_loops) {
+        fprintf(stderr, "-w and -e select different engines; use one of them\n");
+        return -1;
+    }
+    if (cfg->ipc == IPC_UNIX && (cfg->shard || cfg->align)) {
+        fprintf(stderr, "-r/-A need SO_REUSEPORT, which Unix sockets do not have\n");
+        return -1;
+    }
+    if (cfg->shard && !cfg->event_loops) {
+        fprintf(stderr, "-r only applies to the epoll engine (-e)\n");
+        return -1;
+    }
+    if ((cfg->cpu_count || cfg->align) && !cfg->workers && !cfg->event_loops) {
+        fprintf(stderr, "-c/-A need pre-spawned threads (-w or -e)\n");
+        return -1;
+    }
+    if (cfg->align) {
+        int threads = cfg->workers ? cfg->workers : cfg->event_loops;
+        if (cfg->event_loops) cfg->shard = 1; // Steering needs one listener per loop
+        if (cfg->cpu_count == 0) {
+            // Default alignment: worker i on CPU i
+            cfg->cpu_count = threads < MAX_PINNED_CPUS ? threads : MAX_PINNED_CPUS;
+            for (int i = 0; i < cfg->cpu_count; i++) cfg->cpus[i] = i;
+        }
+        for (int i = 0; i < threads; i++) {
+            int cpu = cfg->cpus[i % cfg->cpu_count];
+            if (cpu % threads != i) {
+                fprintf(stderr, "Warning: -A steers CPU %d to worker %d, but worker %d runs on CPU %d\n",
+                        cpu, cpu % threads, i, cpu);
+            }
+        }
+    }
+    return 0;
+}
+
+// Readiness for a managing process (MT25073_Part_C_Bench.c): if it passed
+// the write end of a pipe in READY_FD_ENV, write one byte once every
+// listener is bound and listening. Connects from then on are queued, so the
+// manager needs no sleep, and a server that dies first just closes the pipe.
+void notify_ready(void) {
+    const char *env = getenv(READY_FD_ENV);
+    if (!env) return;
+    int fd = atoi(env);
+    if (write(fd, "R", 1) != 1) perror("ready notification");
+    close(fd);
+    unsetenv(READY_FD_ENV);
+}
+
+// Entry point used by every server's main().
+int run_server(int argc, char *argv[], const transport_ops_t *ops) {
+    server_config_t cfg;
+    if (parse_server_args(argc, argv, &cfg) != 0) return EXIT_FAILURE;
+    if (ops->check_config && ops->check_config(&cfg) != 0) return EXIT_FAILURE;
+    server_config = cfg;
+    if (cfg.event_loops > 0 && ops->blocking_only) {
+        fprintf(stderr, "%s waits for its own completions and cannot run on the epoll engine\n",
+                ops->name);
+        return EXIT_FAILURE;
+    }
+
+    if (cfg.batching) {
+        if (cfg.batch == BATCH_AUTO)
+            printf("Batching: %s, K from a %u us latency budget\n",
+                   batch_mode_names[cfg.batch_mode], cfg.batch_budget_us);
+        else
+            printf("Batching: %s, K=%u\n", batch_mode_names[cfg.batch_mode], cfg.batch);
+    }
+
+    // Per-connection reports must reach a redirected log before the server
+    // is interrupted, not sit in a full stdio buffer.
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // A client closing early must not kill the whole server with SIGPIPE.
+    signal(SIGPIPE, SIG_IGN);
+    raise_fd_limit(); // One descriptor per client connection
+    if (cfg.metrics_path && metrics_open(cfg.metrics_path, ops->name, PORT) == 0)
+        printf("Metrics: %s\n", cfg.metrics_path);
+
+    int listener_count;
+    int *listen_fds = open_listeners(&cfg, &listener_count);
+    notify_ready();
+
+    char where[UNIX_PATH_LEN + 16];
+    if (cfg.ipc == IPC_UNIX) snprintf(where, sizeof(where), "Unix socket %s", cfg.unix_path);
+    else snprintf(where, sizeof(where), "port %d", PORT);
+    if (cfg.event_loops > 0) {
+        printf("Server %s listening on %s (%d epoll loops, %d listener%s)...\n",
+               ops->name, where, cfg.event_loops, listener_count, listener_count > 1 ? "s" : "");
+        run_event_loops(listen_fds, listener_count, ops, &cfg);
+    } else if (cfg.workers > 0) {
+        printf("Server %s listening on %s (%d pooled workers%s)...\n",
+               ops->name, where, cfg.workers, cfg.align ? ", CPU-steered" : "");
+        run_worker_pool(listen_fds, ops, &cfg);
+    } else {
+        printf("Server %s listening on %s...\n", ops->name, where);
+        accept_loop(listen_fds[0], ops);
+    }
+
+    for (int i = 0; i < listener_count; i++) close(listen_fds[i]);
+    free(listen_fds);
+    return 0;
+}
+
+#endif
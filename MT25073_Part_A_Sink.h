@@ -0,0 +1,171 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Sink.h
+ * Description: Receive strategies ("sinks") for the load generator.
+ * A plain recv() copies every byte into user space, so at high rates the
+ * client's own copy can become the bottleneck. The other sinks consume the
+ * stream without that copy, which shows whether a measured Gbps number is
+ * the server's send path or the client's receive path:
+ *   recv     : read() into a msg_size buffer (socket or pipe)       (default)
+ *   trunc    : recv(MSG_TRUNC) - the kernel discards the bytes, no copy (TCP)
+ *   splice   : splice(socket -> pipe -> /dev/null), pages never reach user space
+ *   zerocopy : TCP_ZEROCOPY_RECEIVE - payload pages are mapped into a
+ *              window of our address space; unaligned tails are recv()'d (TCP)
+ * Each client thread owns one receive_sink_t.
+ */
+
+#ifndef MT25073_PART_A_SINK_H
+#define MT25073_PART_A_SINK_H
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <netinet/tcp.h>
+
+#define SINK_RECV     0
+#define SINK_TRUNC    1
+#define SINK_SPLICE   2
+#define SINK_ZEROCOPY 3
+
+#define SINK_PIPE_SIZE   (1024 * 1024)  // Requested splice pipe capacity
+#define SINK_ZC_WINDOW   (2 * 1024 * 1024) // Minimum TCP_ZEROCOPY_RECEIVE mapping
+
+typedef struct {
+    int mode;
+    char *buffer;            // recv() target (also the zerocopy tail buffer)
+    size_t buf_len;
+    int pipe_fd[2];          // SINK_SPLICE
+    int devnull;             // SINK_SPLICE
+    void *zc_addr;           // SINK_ZEROCOPY: mapping of the socket
+    size_t zc_len;
+    long long bytes_mapped;  // SINK_ZEROCOPY: bytes delivered by page mapping
+} receive_sink_t;
+
+int sink_mode(const char *name) {
+    if (strcmp(name, "recv") == 0) return SINK_RECV;
+    if (strcmp(name, "trunc") == 0) return SINK_TRUNC;
+    if (strcmp(name, "splice") == 0) return SINK_SPLICE;
+    if (strcmp(name, "zerocopy") == 0) return SINK_ZEROCOPY;
+    return -1;
+}
+
+const char *sink_name(int mode) {
+    if (mode == SINK_TRUNC) return "trunc";
+    if (mode == SINK_SPLICE) return "splice";
+    if (mode == SINK_ZEROCOPY) return "zerocopy";
+    return "recv";
+}
+
+// Prepare the sink for one connection. Returns 0 on success.
+int sink_open(receive_sink_t *sink, int mode, int sock, size_t msg_size) {
+    memset(sink, 0, sizeof(*sink));
+    sink->mode = mode;
+    sink->pipe_fd[0] = sink->pipe_fd[1] = sink->devnull = -1;
+    sink->buf_len = msg_size;
+    sink->buffer = (char *)malloc(msg_size);
+    if (!sink->buffer) return -1;
+
+    if (mode == SINK_SPLICE) {
+        if (pipe2(sink->pipe_fd, O_CLOEXEC) < 0) {
+            perror("pipe2");
+            return -1;
+        }
+        fcntl(sink->pipe_fd[1], F_SETPIPE_SZ, SINK_PIPE_SIZE); // Best effort
+        sink->devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (sink->devnull < 0) {
+            perror("open /dev/null");
+            return -1;
+        }
+    } else if (mode == SINK_ZEROCOPY) {
+        // The mapping must be page aligned and a multiple of the page size.
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t len = msg_size < SINK_ZC_WINDOW ? SINK_ZC_WINDOW : msg_size;
+        sink->zc_len = (len + page - 1) / page * page;
+        sink->zc_addr = mmap(NULL, sink->zc_len, PROT_READ, MAP_SHARED, sock, 0);
+        if (sink->zc_addr == MAP_FAILED) {
+            perror("mmap socket (TCP_ZEROCOPY_RECEIVE unsupported?), using recv");
+            sink->zc_addr = NULL;
+            sink->mode = SINK_RECV;
+        }
+    }
+    return 0;
+}
+
+// TCP_ZEROCOPY_RECEIVE: map what is page aligned, recv() the rest.
+ssize_t sink_read_zerocopy(receive_sink_t *sink, int sock) {
+    // Wait for data (or EOF) - the getsockopt below never blocks.
+    struct pollfd pfd = { .fd = sock, .events = POLLIN };
+    while (poll(&pfd, 1, -1) < 0) {
+        if (errno != EINTR) return -1;
+    }
+
+    struct tcp_zerocopy_receive zc;
+    memset(&zc, 0, sizeof(zc));
+    zc.address = (uint64_t)(unsigned long)sink->zc_addr;
+    zc.length = sink->zc_len;
+    socklen_t zc_len = sizeof(zc);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, &zc, &zc_len) < 0) {
+        return recv(sock, sink->buffer, sink->buf_len, 0); // Kernel refused: plain copy
+    }
+
+    ssize_t total = zc.length;
+    sink->bytes_mapped += zc.length;
+
+    // Bytes that could not be mapped (partial pages) are copied as usual.
+    size_t skip = zc.recv_skip_hint;
+    if (zc.length == 0 && skip == 0) {
+        // Nothing mappable at all: small segments, or EOF.
+        return recv(sock, sink->buffer, sink->buf_len, 0);
+    }
+    while (skip > 0) {
+        size_t chunk = skip < sink->buf_len ? skip : sink->buf_len;
+        ssize_t n = recv(sock, sink->buffer, chunk, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return total > 0 ? total : n;
+        total += n;
+        skip -= n;
+    }
+    return total;
+}
+
+// Consume up to `want` bytes from the socket (blocking).
+// Returns the bytes consumed, 0 on EOF, -1 on error - just like recv().
+ssize_t sink_read(receive_sink_t *sink, int sock, size_t want) {
+    switch (sink->mode) {
+    case SINK_TRUNC:
+        // TCP drops the data in the kernel and reports how much it dropped.
+        return recv(sock, NULL, want, MSG_TRUNC);
+
+    case SINK_SPLICE: {
+        ssize_t n = splice(sock, NULL, sink->pipe_fd[1], NULL, want, SPLICE_F_MOVE);
+        if (n <= 0) return n;
+        // Drain the pipe so the next splice has room.
+        ssize_t left = n;
+        while (left > 0) {
+            ssize_t out = splice(sink->pipe_fd[0], NULL, sink->devnull, NULL, left, SPLICE_F_MOVE);
+            if (out < 0 && errno == EINTR) continue;
+            if (out <= 0) return -1;
+            left -= out;
+        }
+        return n;
+    }
+
+    case SINK_ZEROCOPY:
+        return sink_read_zerocopy(sink, sock);
+
+    default:
+        // read() rather than recv(): with -i pipe, `sock` is a pipe.
+        return read(sock, sink->buffer, want < sink->buf_len ? want : sink->buf_len);
+    }
+}
+
+void sink_close(receive_sink_t *sink) {
+    if (sink->pipe_fd[0] >= 0) close(sink->pipe_fd[0]);
+    if (sink->pipe_fd[1] >= 0) close(sink->pipe_fd[1]);
+    if (sink->devnull >= 0) close(sink->devnull);
+    if (sink->zc_addr) munmap(sink->zc_addr, sink->zc_len);
+    free(sink->buffer);
+    sink->buffer = NULL;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Stitch.h
+ * Description: Copy kernels for A1's user-space "stitching" copy.
+ * Plain memcpy() writes through the cache: stitching a message larger than
+ * the LLC evicts everything else (the payload, the socket buffers, other
+ * threads' data) just to write bytes that are read exactly once by send().
+ * Above a threshold we therefore copy with non-temporal (streaming) stores,
+ * which go to memory without allocating cache lines. Below it, memcpy() is
+ * faster because send() then finds the stitched bytes in the cache.
+ * The widest kernel the CPU supports is picked at run time:
+ *   memcpy  : glibc memcpy (regular stores)
+ *   sse2    : 16-byte _mm_stream_si128
+ *   avx2    : 32-byte _mm256_stream_si256
+ *   avx512  : 64-byte _mm512_stream_si512
+ */
+
+#ifndef MT25073_PART_A_STITCH_H
+#define MT25073_PART_A_STITCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STITCH_X86 1
+#endif
+
+#define STITCH_DEFAULT_LLC (8UL * 1024 * 1024) // If the LLC size cannot be read
+
+typedef void (*stitch_copy_fn)(char *dst, const char *src, size_t len);
+
+typedef struct {
+    const char *name;
+    stitch_copy_fn copy;
+    int non_temporal;      // Bypasses the cache (needs stitch_fence() before send)
+} stitch_kernel_t;
+
+void stitch_copy_memcpy(char *dst, const char *src, size_t len) {
+    memcpy(dst, src, len);
+}
+
+#ifdef STITCH_X86
+// Each kernel: regular memcpy() up to the first vector-aligned destination
+// byte, 4 streaming stores per iteration, then single vectors, then the tail.
+
+__attribute__((target("sse2")))
+void stitch_copy_sse2(char *dst, const char *src, size_t len) {
+    size_t head = (-(uintptr_t)dst) & 15;
+    if (head > len) head = len;
+    memcpy(dst, src, head);
+    dst += head, src += head, len -= head;
+    for (; len >= 64; len -= 64, src += 64, dst += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *)src);
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+        _mm_stream_si128((__m128i *)dst, a);
+        _mm_stream_si128((__m128i *)(dst + 16), b);
+        _mm_stream_si128((__m128i *)(dst + 32), c);
+        _mm_stream_si128((__m128i *)(dst + 48), d);
+    }
+    for (; len >= 16; len -= 16, src += 16, dst += 16)
+        _mm_stream_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+    memcpy(dst, src, len);
+}
+
+__attribute__((target("avx2")))
+void stitch_copy_avx2(char *dst, const char *src, size_t len) {
+    size_t head = (-(uintptr_t)dst) & 31;
+    if (head > len) head = len;
+    memcpy(dst, src, head);
+    dst += head, src += head, len -= head;
+    for (; len >= 128; len -= 128, src += 128, dst += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)src);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(src + 96));
+        _mm256_stream_si256((__m256i *)dst, a);
+        _mm256_stream_si256((__m256i *)(dst + 32), b);
+        _mm256_stream_si256((__m256i *)(dst + 64), c);
+        _mm256_stream_si256((__m256i *)(dst + 96), d);
+    }
+    for (; len >= 32; len -= 32, src += 32, dst += 32)
+        _mm256_stream_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+    memcpy(dst, src, len);
+}
+
+__attribute__((target("avx512f")))
+void stitch_copy_avx512(char *dst, const char *src, size_t len) {
+    size_t head = (-(uintptr_t)dst) & 63;
+    if (head > len) head = len;
+    memcpy(dst, src, head);
+    dst += head, src += head, len -= head;
+    for (; len >= 256; len -= 256, src += 256, dst += 256) {
+        __m512i a = _mm512_loadu_si512((const void *)src);
+        __m512i b = _mm512_loadu_si512((const void *)(src + 64));
+        __m512i c = _mm512_loadu_si512((const void *)(src + 128));
+        __m512i d = _mm512_loadu_si512((const void *)(src + 192));
+        _mm512_stream_si512((void *)dst, a);
+        _mm512_stream_si512((void *)(dst + 64), b);
+        _mm512_stream_si512((void *)(dst + 128), c);
+        _mm512_stream_si512((void *)(dst + 192), d);
+    }
+    for (; len >= 64; len -= 64, src += 64, dst += 64)
+        _mm512_stream_si512((void *)dst, _mm512_loadu_si512((const void *)src));
+    memcpy(dst, src, len);
+}
+#endif
+
+const stitch_kernel_t stitch_kernels[] = {
+    { "memcpy", stitch_copy_memcpy, 0 },
+#ifdef STITCH_X86
+    { "sse2",   stitch_copy_sse2,   1 },
+    { "avx2",   stitch_copy_avx2,   1 },
+    { "avx512", stitch_copy_avx512, 1 },
+#endif
+};
+#define STITCH_KERNEL_COUNT ((int)(sizeof(stitch_kernels) / sizeof(stitch_kernels[0])))
+
+int stitch_kernel_supported(const stitch_kernel_t *k) {
+#ifdef STITCH_X86
+    __builtin_cpu_init();
+    if (k->copy == stitch_copy_sse2) return __builtin_cpu_supports("sse2");
+    if (k->copy == stitch_copy_avx2) return __builtin_cpu_supports("avx2");
+    if (k->copy == stitch_copy_avx512) return __builtin_cpu_supports("avx512f");
+#endif
+    return k->copy == stitch_copy_memcpy;
+}
+
+// Kernel by name (NULL = widest supported). NULL if unknown or unsupported.
+const stitch_kernel_t *stitch_kernel_find(const char *name) {
+    const stitch_kernel_t *best = NULL;
+    for (int i = 0; i < STITCH_KERNEL_COUNT; i++) {
+        const stitch_kernel_t *k = &stitch_kernels[i];
+        if (!stitch_kernel_supported(k)) continue;
+        if (name && strcmp(name, k->name) == 0) return k;
+        if (!name) best = k; // Table is ordered narrow -> wide
+    }
+    return best;
+}
+
+// Last-level cache size of this machine (bytes).
+size_t stitch_llc_size(void) {
+    long llc = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc <= 0) llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return llc > 0 ? (size_t)llc : STITCH_DEFAULT_LLC;
+}
+
+// Streaming stores are weakly ordered: make them globally visible before
+// the buffer is handed to send() (or another thread).
+void stitch_fence(void) {
+#ifdef STITCH_X86
+    _mm_sfence();
+#endif
+}
+
+#endif
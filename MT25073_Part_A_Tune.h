@@ -0,0 +1,215 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Tune.h
+ * Description: Socket tuning profiles (server -T, client -T).
+ * Without a profile every connection runs with the kernel's defaults:
+ * autotuned buffers, Nagle on (except ping-pong and paced streams), no busy
+ * polling, no pacing. A profile is a comma-separated list of presets and
+ * settings, e.g. "throughput,sndbuf=8M" or "nodelay=1,lowat=64K":
+ *   sndbuf=N      SO_SNDBUF (SO_SNDBUFFORCE when permitted), bytes, K/M/G suffix
+ *   rcvbuf=N      SO_RCVBUF (SO_RCVBUFFORCE when permitted)
+ *   nodelay=0|1   TCP_NODELAY
+ *   lowat=N       TCP_NOTSENT_LOWAT: unsent bytes the socket queues before
+ *                 it stops reporting writable / blocks the sender
+ *   busypoll=us   SO_BUSY_POLL: spin this long in the driver on receive
+ *   preferbusy=0|1 SO_PREFER_BUSY_POLL
+ *   pacing=N      SO_MAX_PACING_RATE, bytes per second, K/M/G suffix
+ *   throughput    preset: sndbuf=4M,rcvbuf=4M,nodelay=0
+ *   latency       preset: nodelay=1,lowat=16K,busypoll=50,preferbusy=1
+ * Both ends apply the whole profile to their socket: the client before
+ * connect() (the window scale is fixed by the SYN), the server after the
+ * handshake. The server starts from its own -T profile; every setting the
+ * client sent in the handshake overrides it. The server then logs what the
+ * kernel made of it (getsockopt): buffer sizes come back doubled, and are
+ * capped at net.core.[rw]mem_max without CAP_NET_ADMIN.
+ * Shared by the servers and the client (the profile travels in handshake_t).
+ */
+
+#ifndef MT25073_PART_A_TUNE_H
+#define MT25073_PART_A_TUNE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_MAX_PACING_RATE
+#define SO_MAX_PACING_RATE 47
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
+#define TUNE_SNDBUF     (1u << 0)
+#define TUNE_RCVBUF     (1u << 1)
+#define TUNE_NODELAY    (1u << 2)
+#define TUNE_LOWAT      (1u << 3)
+#define TUNE_BUSY_POLL  (1u << 4)
+#define TUNE_PREFER     (1u << 5)
+#define TUNE_PACING     (1u << 6)
+#define TUNE_TCP_ONLY   (TUNE_NODELAY | TUNE_LOWAT) // IPPROTO_TCP options
+
+// Fixed-width: part of handshake_t. Only the settings in `mask` are applied.
+typedef struct {
+    uint64_t pacing;           // Bytes per second
+    uint32_t mask;             // TUNE_* of the settings that were given
+    uint32_t sndbuf;
+    uint32_t rcvbuf;
+    uint32_t nodelay;
+    uint32_t notsent_lowat;
+    uint32_t busy_poll;        // Microseconds
+    uint32_t prefer_busy_poll;
+    uint32_t reserved;
+} tune_t;
+
+// "64K", "4M", "1G", "1000" -> value (binary suffixes). -1 if invalid.
+long long tune_parse_size(const char *text) {
+    char *end;
+    long long v = strtoll(text, &end, 10);
+    if (end == text || v < 0) return -1;
+    if (*end == 'K' || *end == 'k') v <<= 10, end++;
+    else if (*end == 'M' || *end == 'm') v <<= 20, end++;
+    else if (*end == 'G' || *end == 'g') v <<= 30, end++;
+    return *end == '\0' ? v : -1;
+}
+
+// Add one "key=value" or preset to `t`. Returns -1 if unknown or out of range.
+int tune_parse_item(const char *item, tune_t *t) {
+    if (strcmp(item, "throughput") == 0)
+        return tune_parse_item("sndbuf=4M", t) | tune_parse_item("rcvbuf=4M", t) |
+               tune_parse_item("nodelay=0", t);
+    if (strcmp(item, "latency") == 0)
+        return tune_parse_item("nodelay=1", t) | tune_parse_item("lowat=16K", t) |
+               tune_parse_item("busypoll=50", t) | tune_parse_item("preferbusy=1", t);
+
+    const char *eq = strchr(item, '=');
+    if (!eq) return -1;
+    size_t key_len = eq - item;
+    long long v = tune_parse_size(eq + 1);
+    if (v < 0) return -1;
+#define TUNE_KEY(name) (key_len == strlen(name) && strncmp(item, name, key_len) == 0)
+    if (TUNE_KEY("pacing")) {
+        t->pacing = (uint64_t)v;
+        t->mask |= TUNE_PACING;
+        return 0;
+    }
+    if (v > INT32_MAX) return -1; // setsockopt() takes an int
+    if (TUNE_KEY("sndbuf")) t->sndbuf = v, t->mask |= TUNE_SNDBUF;
+    else if (TUNE_KEY("rcvbuf")) t->rcvbuf = v, t->mask |= TUNE_RCVBUF;
+    else if (TUNE_KEY("nodelay") && v <= 1) t->nodelay = v, t->mask |= TUNE_NODELAY;
+    else if (TUNE_KEY("lowat")) t->notsent_lowat = v, t->mask |= TUNE_LOWAT;
+    else if (TUNE_KEY("busypoll")) t->busy_poll = v, t->mask |= TUNE_BUSY_POLL;
+    else if (TUNE_KEY("preferbusy") && v <= 1) t->prefer_busy_poll = v, t->mask |= TUNE_PREFER;
+    else return -1;
+#undef TUNE_KEY
+    return 0;
+}
+
+// Add a whole profile ("latency,sndbuf=1M") to `t`; later settings win.
+int tune_parse(const char *spec, tune_t *t) {
+    char buf[256], *save = NULL;
+    if (strlen(spec) >= sizeof(buf)) return -1;
+    strcpy(buf, spec);
+    for (char *w = strtok_r(buf, ",", &save); w; w = strtok_r(NULL, ",", &save))
+        if (tune_parse_item(w, t) != 0) return -1;
+    return 0;
+}
+
+// Settings given in `over` replace those of `base`.
+void tune_merge(tune_t *base, const tune_t *over) {
+    if (over->mask & TUNE_SNDBUF) base->sndbuf = over->sndbuf;
+    if (over->mask & TUNE_RCVBUF) base->rcvbuf = over->rcvbuf;
+    if (over->mask & TUNE_NODELAY) base->nodelay = over->nodelay;
+    if (over->mask & TUNE_LOWAT) base->notsent_lowat = over->notsent_lowat;
+    if (over->mask & TUNE_BUSY_POLL) base->busy_poll = over->busy_poll;
+    if (over->mask & TUNE_PREFER) base->prefer_busy_poll = over->prefer_busy_poll;
+    if (over->mask & TUNE_PACING) base->pacing = over->pacing;
+    base->mask |= over->mask;
+}
+
+// Buffer size: the FORCE variant ignores [rw]mem_max but needs CAP_NET_ADMIN.
+int tune_set_buffer(int sock, int force_opt, int opt, int value) {
+    if (setsockopt(sock, SOL_SOCKET, force_opt, &value, sizeof(value)) == 0) return 0;
+    return setsockopt(sock, SOL_SOCKET, opt, &value, sizeof(value));
+}
+
+// Apply the settings of `t` to `sock`. TCP-level options are skipped
+// unless `tcp`. Returns the TUNE_* bits the kernel refused.
+uint32_t tune_apply(int sock, const tune_t *t, int tcp) {
+    uint32_t refused = 0;
+    int v;
+    if ((t->mask & TUNE_SNDBUF) && tune_set_buffer(sock, SO_SNDBUFFORCE, SO_SNDBUF, t->sndbuf))
+        refused |= TUNE_SNDBUF;
+    if ((t->mask & TUNE_RCVBUF) && tune_set_buffer(sock, SO_RCVBUFFORCE, SO_RCVBUF, t->rcvbuf))
+        refused |= TUNE_RCVBUF;
+    if (tcp && (t->mask & TUNE_NODELAY)) {
+        v = t->nodelay;
+        if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &v, sizeof(v))) refused |= TUNE_NODELAY;
+    }
+    if (tcp && (t->mask & TUNE_LOWAT)) {
+        v = t->notsent_lowat;
+        if (setsockopt(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &v, sizeof(v))) refused |= TUNE_LOWAT;
+    }
+    if (t->mask & TUNE_BUSY_POLL) {
+        v = t->busy_poll;
+        if (setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &v, sizeof(v))) refused |= TUNE_BUSY_POLL;
+    }
+    if (t->mask & TUNE_PREFER) {
+        v = t->prefer_busy_poll;
+        if (setsockopt(sock, SOL_SOCKET, SO_PREFER_BUSY_POLL, &v, sizeof(v))) refused |= TUNE_PREFER;
+    }
+    if (t->mask & TUNE_PACING) {
+        uint64_t rate = t->pacing;
+        if (setsockopt(sock, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)))
+            refused |= TUNE_PACING;
+    }
+    return refused;
+}
+
+// --- Effective values, as the kernel reports them ---
+// "sndbuf=N rcvbuf=N nodelay=N lowat=N busypoll=N preferbusy=N pacing=N"
+// (lowat and pacing print "max" when unlimited, "n/a" where not supported),
+// followed by "(refused: ...)" for settings setsockopt() rejected.
+void tune_print_int(FILE *out, const char *name, int sock, int level, int opt) {
+    int v = 0;
+    socklen_t len = sizeof(v);
+    if (getsockopt(sock, level, opt, &v, &len) < 0) fprintf(out, " %s=n/a", name);
+    else if ((unsigned)v == UINT32_MAX) fprintf(out, " %s=max", name);
+    else fprintf(out, " %s=%d", name, v);
+}
+
+void tune_report(FILE *out, const char *prefix, int sock, int tcp, uint32_t refused) {
+    static const char *names[] = { "sndbuf", "rcvbuf", "nodelay", "lowat", "busypoll",
+                                   "preferbusy", "pacing" };
+    fprintf(out, "%sSocket:", prefix);
+    tune_print_int(out, "sndbuf", sock, SOL_SOCKET, SO_SNDBUF);
+    tune_print_int(out, "rcvbuf", sock, SOL_SOCKET, SO_RCVBUF);
+    if (tcp) {
+        tune_print_int(out, "nodelay", sock, IPPROTO_TCP, TCP_NODELAY);
+        tune_print_int(out, "lowat", sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT);
+    }
+    tune_print_int(out, "busypoll", sock, SOL_SOCKET, SO_BUSY_POLL);
+    tune_print_int(out, "preferbusy", sock, SOL_SOCKET, SO_PREFER_BUSY_POLL);
+    uint64_t rate = 0;
+    socklen_t len = sizeof(rate);
+    if (getsockopt(sock, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, &len) < 0) fprintf(out, " pacing=n/a");
+    else if (rate == UINT64_MAX || (len == sizeof(uint32_t) && (uint32_t)rate == UINT32_MAX))
+        fprintf(out, " pacing=max");
+    else fprintf(out, " pacing=%llu", (unsigned long long)(len == sizeof(uint32_t) ? (uint32_t)rate : rate));
+    if (refused) {
+        fprintf(out, " (refused:");
+        for (int i = 0; i < 7; i++)
+            if (refused & (1u << i)) fprintf(out, " %s", names[i]);
+        fprintf(out, ")");
+    }
+    fprintf(out, "\n");
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_A_Unified_Server.c
+ * Part: A (all transports in one server)
+ * Description: One server process for the whole benchmark matrix. Each
+ * client names the transport it wants in the handshake (client -t), and the
+ * connection is dispatched through the strategy table below. Sweeps can then
+ * run back to back against one warm process instead of restarting a
+ * different server binary for every cell.
+ * Clients that do not pick a transport get A2 One-Copy.
+ * io_uring connections are refused on the epoll engine (-e).
+ */
+
+#include "MT25073_Part_A1_Transport.h"
+#include "MT25073_Part_A2_Transport.h"
+#include "MT25073_Part_A3_Transport.h"
+#include "MT25073_Part_A4_Transport.h"
+#include "MT25073_Part_A5_Transport.h"
+#include "MT25073_Part_A6_Transport.h"
+
+// To add a transport: give it a TRANSPORT_* id in MT25073_Part_A_Common.h,
+// include its header above and list it here.
+const transport_entry_t unified_transports[] = {
+    { TRANSPORT_TWO_COPY,        &two_copy_ops,  NULL },
+    { TRANSPORT_ONE_COPY,        &one_copy_ops,  NULL },
+    { TRANSPORT_ZERO_COPY,       &zero_copy_ops, NULL },
+    { TRANSPORT_IO_URING,        &uring_ops,     NULL },
+    { TRANSPORT_SENDFILE,        &kfile_ops,     "sendfile" },
+    { TRANSPORT_SPLICE,          &kfile_ops,     "splice" },
+    { TRANSPORT_VMSPLICE,        &kfile_ops,     "vmsplice" },
+    { TRANSPORT_ADAPTIVE,        &adaptive_ops,  "static" },
+    { TRANSPORT_ADAPTIVE_ONLINE, &adaptive_ops,  "online" },
+};
+
+// The variant comes from the table entry, so -m has nothing to select here.
+int unified_check_config(const server_config_t *cfg) {
+    if (cfg->variant) {
+        fprintf(stderr, "The unified server takes no -m; clients choose with -t <transport>\n");
+        return -1;
+    }
+    return 0;
+}
+
+const transport_ops_t unified_default_ops = {
+    .name = "A2 One-Copy",
+    .setup = NULL,
+    .send_message = one_copy_send,
+    .on_error_queue = NULL,
+    .teardown = NULL,
+    .check_config = unified_check_config,
+};
+
+int main(int argc, char *argv[]) {
+    transport_table = unified_transports;
+    transport_table_len = sizeof(unified_transports) / sizeof(unified_transports[0]);
+    return run_server(argc, argv, &unified_default_ops);
+}
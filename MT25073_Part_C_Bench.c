@@ -0,0 +1,647 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_C_Bench.c
+ * Part: C (Automation)
+ * Description: Benchmark driver with warmup, repetitions and confidence
+ * intervals. The runner script measures every cell once, waits a fixed
+ * `sleep 1` for the server and scrapes numbers with grep/awk/bc, so a dip in
+ * one cell cannot be told apart from noise. For every (mode, size, threads)
+ * cell this driver:
+ *   1. starts the server as a managed child (with -P) and waits until it
+ *      reports that it is listening (READY_FD_ENV pipe), not a fixed time;
+ *   2. runs the client W times as warmup and throws the results away;
+ *   3. runs the client N more times, parsing each run's client report and
+ *      the server's Perf lines that run added to the server log. Every run
+ *      itself starts with a short warmup (client -W) that both ends leave
+ *      out, so connection setup does not count and 1 s runs are accurate;
+ *   4. stops the server (SIGINT, SIGKILL if it hangs).
+ * Per metric it reports mean, sample standard deviation and the 95%
+ * confidence interval of the mean (Student's t, n-1 degrees of freedom):
+ *   CSV : one row per cell (read by MT25073_Part_D_Plots.py)
+ *   JSON: the same, plus every repetition's raw values
+ * A failed run (client error, no throughput) is counted and left out.
+ * With -b every cell is measured once per socket buffer size (the client's
+ * -T sndbuf=X,rcvbuf=X, which the server applies too), and the driver ends
+ * with the best buffer size per cell against the kernel default ("auto"
+ * sweeps 0 = default, 64K, 256K, 1M, 4M and 16M).
+ *
+ * Usage: ./bench [-m modes] [-s sizes] [-t threads] [-d duration] [-W warmup]
+ *                [-w warmups] [-n reps] [-b buffers|auto] [-S "server flags"] [-C "client flags"]
+ *                [-o csv] [-j json] [-l log]
+ */
+
+#include "MT25073_Part_A_Common.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define BENCH_MAX_LIST   32          // Values per -s / -t / -b list
+#define BENCH_MAX_ARGS   64          // Words per command line
+#define BENCH_READY_MS   10000       // Server must listen within this
+#define BENCH_STOP_MS    3000        // ... and exit this long after SIGINT
+#define BENCH_CLIENT_OUT (256 * 1024) // Client report (a few hundred bytes normally)
+
+// --- What can be measured: servers, clients, handshake names ---
+typedef struct {
+    const char *type;     // CSV "Type", as in the runner's CSV
+    const char *name;     // -m name (the client's -t transport names)
+    const char *server;   // Server command line (before -S flags)
+    const char *client;   // Client binary
+} bench_mode_t;
+
+bench_mode_t bench_modes[] = {
+    { "TwoCopy",        "two-copy",        "server_a1",           "client_a1" },
+    { "OneCopy",        "one-copy",        "server_a2",           "client_a2" },
+    { "ZeroCopy",       "zero-copy",       "server_a3",           "client_a3" },
+    { "IoUring",        "io_uring",        "server_a4",           "client_a4" },
+    { "Sendfile",       "sendfile",        "server_a5 -m sendfile", "client_a5" },
+    { "Splice",         "splice",          "server_a5 -m splice", "client_a5" },
+    { "Vmsplice",       "vmsplice",        "server_a5 -m vmsplice", "client_a5" },
+    { "AdaptiveStatic", "adaptive",        "server_a6 -m static", "client_a6" },
+    { "AdaptiveOnline", "adaptive-online", "server_a6 -m online", "client_a6" },
+};
+#define BENCH_MODE_COUNT ((int)(sizeof(bench_modes) / sizeof(bench_modes[0])))
+
+// --- Metrics of one run; a value < 0 means "not available" ---
+#define BM_THROUGHPUT  0 // Gbps (client)
+#define BM_MSG_RATE    1 // Messages/s, all connections (client)
+#define BM_P50         2 // us, message latency or RTT (client histogram)
+#define BM_P99         3
+#define BM_P999        4
+#define BM_CYCLES_B    5 // Server cycles per byte sent (-P)
+#define BM_IPC         6 // Server instructions per cycle
+#define BM_L1D_KB      7 // Server L1D read misses per KB
+#define BM_LLC_KB      8 // Server LLC misses per KB
+#define BM_CS          9 // Server context switches during the transfer loops
+#define BM_COUNT       10
+
+const char *bench_metric_names[BM_COUNT] = {
+    "throughput_gbps", "msg_rate", "p50_us", "p99_us", "p999_us",
+    "cycles_per_byte", "ipc", "l1d_miss_per_kb", "llc_miss_per_kb", "cs"
+};
+
+typedef struct {
+    int n;
+    double mean, sd, ci95; // ci95: half-width, the mean is in [mean - ci95, mean + ci95]
+} bench_stat_t;
+
+typedef struct {
+    const bench_mode_t *modes[BENCH_MODE_COUNT];
+    int mode_count;
+    long sizes[BENCH_MAX_LIST];
+    int size_count;
+    long threads[BENCH_MAX_LIST];
+    int thread_count;
+    long buffers[BENCH_MAX_LIST];  // -b: SO_SNDBUF/SO_RCVBUF sizes, 0 = kernel default
+    int buffer_count;
+    long duration_ms;              // -d: measurement window of every run
+    long run_warmup_ms;            // -W: warmup inside every run (client -W)
+    int warmup, reps;              // -w, -n: runs per cell
+    const char *server_flags, *client_flags;
+    const char *csv_path, *json_path, *log_path;
+} bench_config_t;
+
+bench_config_t bench_config;
+volatile pid_t bench_server_pid = 0; // Killed if the driver is interrupted
+
+// ---------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------
+
+// Two-sided 95% quantile of Student's t with `df` degrees of freedom.
+double t_quantile_95(int df) {
+    static const double t[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df <= 30) return t[df - 1];
+    if (df <= 40) return 2.021;
+    if (df <= 60) return 2.000;
+    if (df <= 120) return 1.980;
+    return 1.960;
+}
+
+// Statistics of the available (>= 0) values among v[0..count-1].
+void bench_stat(const double *v, int count, bench_stat_t *st) {
+    memset(st, 0, sizeof(*st));
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        if (v[i] >= 0) {
+            sum += v[i];
+            st->n++;
+        }
+    if (st->n == 0) return;
+    st->mean = sum / st->n;
+    if (st->n < 2) return; // One value: no spread to speak of
+    double sq = 0;
+    for (int i = 0; i < count; i++)
+        if (v[i] >= 0) sq += (v[i] - st->mean) * (v[i] - st->mean);
+    st->sd = sqrt(sq / (st->n - 1));
+    st->ci95 = t_quantile_95(st->n - 1) * st->sd / sqrt(st->n);
+}
+
+// ---------------------------------------------------------------------
+// Managed child processes
+// ---------------------------------------------------------------------
+
+// Split `cmd` at spaces into argv[] (in `buf`); the program is looked up in
+// the current directory like the runner does. Returns argc.
+int split_command(const char *cmd, char *buf, size_t buf_len, char **argv, int max) {
+    int argc = 0;
+    snprintf(buf, buf_len, "%s", cmd);
+    for (char *save = NULL, *w = strtok_r(buf, " ", &save); w && argc < max - 1;
+         w = strtok_r(NULL, " ", &save))
+        argv[argc++] = w;
+    argv[argc] = NULL;
+    return argc;
+}
+
+void exec_local(char **argv) {
+    char path[256];
+    snprintf(path, sizeof(path), strchr(argv[0], '/') ? "%s" : "./%s", argv[0]);
+    execv(path, argv);
+    fprintf(stderr, "exec %s: %s\n", path, strerror(errno));
+    _exit(127);
+}
+
+// Wait up to `ms` for `pid` to exit. Returns its status, or -1 on timeout.
+int wait_exit(pid_t pid, int ms) {
+    for (int waited = 0; waited <= ms; waited += 10) {
+        int status;
+        if (waitpid(pid, &status, WNOHANG) == pid) return status;
+        struct timespec ts = { 0, 10 * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+    return -1;
+}
+
+// Start `cmd` + extra flags + -P with stdout/stderr in `log_fd`, and wait
+// for its readiness byte. Returns the pid, or -1 if it never listened.
+pid_t start_server(const char *cmd, const char *flags, int log_fd) {
+    char line[1024], buf[1024];
+    char *argv[BENCH_MAX_ARGS];
+    snprintf(line, sizeof(line), "%s %s -P", cmd, flags ? flags : "");
+    split_command(line, buf, sizeof(buf), argv, BENCH_MAX_ARGS);
+
+    int ready[2];
+    if (pipe2(ready, O_CLOEXEC) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        // The write end must survive exec(); it is the only one left open.
+        char fd_text[16];
+        int fd = dup(ready[1]);
+        snprintf(fd_text, sizeof(fd_text), "%d", fd);
+        setenv(READY_FD_ENV, fd_text, 1);
+        dup2(log_fd, STDOUT_FILENO);
+        dup2(log_fd, STDERR_FILENO);
+        exec_local(argv);
+    }
+    close(ready[1]);
+    bench_server_pid = pid;
+
+    // One byte: listening. EOF: it exited (bind failed, bad flags, ...).
+    struct pollfd pfd = { .fd = ready[0], .events = POLLIN };
+    char byte;
+    int ok = poll(&pfd, 1, BENCH_READY_MS) == 1 && read(ready[0], &byte, 1) == 1;
+    close(ready[0]);
+    if (!ok) {
+        fprintf(stderr, "Server '%s' did not start listening (see %s)\n", line,
+                bench_config.log_path);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        bench_server_pid = 0;
+        return -1;
+    }
+    return pid;
+}
+
+void stop_server(pid_t pid) {
+    kill(pid, SIGINT);
+    if (wait_exit(pid, BENCH_STOP_MS) < 0) {
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+    bench_server_pid = 0;
+}
+
+// Run the client to completion, its stdout into `out`. Returns its exit
+// status (0 = fine), or -1 if it could not run or hung past the duration.
+int run_client(const bench_mode_t *mode, long size, long threads, long buffer, char *out,
+               size_t out_len) {
+    char line[1024], buf[1024], tune[64] = "";
+    char *argv[BENCH_MAX_ARGS];
+    if (buffer > 0) snprintf(tune, sizeof(tune), "-T sndbuf=%ld,rcvbuf=%ld", buffer, buffer);
+    snprintf(line, sizeof(line), "%s -W %ldms %s %s %ld %ld %ldms", mode->client,
+             bench_config.run_warmup_ms, bench_config.client_flags ? bench_config.client_flags : "",
+             tune, size, threads, bench_config.duration_ms);
+    split_command(line, buf, sizeof(buf), argv, BENCH_MAX_ARGS);
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(pipefd[1], STDOUT_FILENO);
+        exec_local(argv);
+    }
+    close(pipefd[1]);
+
+    // Read the report until EOF; a client stuck well past its duration is killed.
+    size_t used = 0;
+    int timeout_ms = (int)(bench_config.run_warmup_ms + bench_config.duration_ms) + 30000;
+    struct pollfd pfd = { .fd = pipefd[0], .events = POLLIN };
+    for (;;) {
+        int r = poll(&pfd, 1, timeout_ms);
+        if (r <= 0) {
+            if (r < 0 && errno == EINTR) continue;
+            fprintf(stderr, "Client '%s' hung, killed\n", line);
+            kill(pid, SIGKILL);
+            break;
+        }
+        char tmp[4096];
+        ssize_t got = read(pipefd[0], tmp, sizeof(tmp));
+        if (got <= 0) break;
+        size_t keep = (size_t)got < out_len - 1 - used ? (size_t)got : out_len - 1 - used;
+        memcpy(out + used, tmp, keep);
+        used += keep;
+    }
+    out[used] = '\0';
+    close(pipefd[0]);
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0) return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// ---------------------------------------------------------------------
+// Parsing the reports
+// ---------------------------------------------------------------------
+
+// The number after `key` in `text` (first occurrence), or -1.
+double value_after(const char *text, const char *key) {
+    const char *p = text ? strstr(text, key) : NULL;
+    double v;
+    if (!p || sscanf(p + strlen(key), " %lf", &v) != 1) return -1;
+    return v;
+}
+
+void parse_client(const char *out, double m[BM_COUNT]) {
+    m[BM_THROUGHPUT] = value_after(out, "Throughput:");
+    double messages = value_after(out, "Messages Received:");
+    double secs = value_after(out, "Time Taken:");
+    m[BM_MSG_RATE] = messages >= 0 && secs > 0 ? messages / secs : -1;
+
+    // "Msg Latency: p50=X p90=X p99=X p99.9=X ..." ("RTT Latency:" in ping-pong)
+    const char *lat = strstr(out, "Msg Latency:");
+    if (!lat) lat = strstr(out, "RTT Latency:");
+    m[BM_P50] = value_after(lat, "p50=");
+    m[BM_P99] = value_after(lat, "p99=");
+    m[BM_P999] = value_after(lat, "p99.9=");
+}
+
+// Sum the Perf lines the server logged from byte `from` of the log on:
+// "Perf: cycles=N instructions=N L1D-misses=N LLC-misses=N cs=N bytes=N | ..."
+void parse_server_perf(int log_fd, off_t from, double m[BM_COUNT]) {
+    const char *keys[] = { " cycles=", " instructions=", " L1D-misses=", " LLC-misses=", " cs=",
+                           " bytes=" };
+    double sum[6] = { 0 };
+    int seen[6] = { 0 };
+
+    struct stat st;
+    if (fstat(log_fd, &st) == 0 && st.st_size > from) {
+        size_t len = st.st_size - from;
+        char *text = malloc(len + 1);
+        ssize_t got = text ? pread(log_fd, text, len, from) : -1;
+        if (got > 0) {
+            text[got] = '\0';
+            for (char *save = NULL, *l = strtok_r(text, "\n", &save); l;
+                 l = strtok_r(NULL, "\n", &save)) {
+                if (!strstr(l, "Perf:")) continue;
+                for (int k = 0; k < 6; k++) {
+                    double v = value_after(l, keys[k]); // n/a does not parse: -1
+                    if (v < 0) continue;
+                    sum[k] += v;
+                    seen[k] = 1;
+                }
+            }
+        }
+        free(text);
+    }
+
+    double bytes = seen[5] ? sum[5] : 0;
+    m[BM_CYCLES_B] = seen[0] && bytes > 0 ? sum[0] / bytes : -1;
+    m[BM_IPC] = seen[0] && seen[1] && sum[0] > 0 ? sum[1] / sum[0] : -1;
+    m[BM_L1D_KB] = seen[2] && bytes > 0 ? sum[2] / (bytes / 1024) : -1;
+    m[BM_LLC_KB] = seen[3] && bytes > 0 ? sum[3] / (bytes / 1024) : -1;
+    m[BM_CS] = seen[4] ? sum[4] : -1;
+}
+
+// ---------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------
+
+void write_csv_header(FILE *csv) {
+    fprintf(csv, "Type,MsgSize,Threads,Buffer,Runs,Failed");
+    for (int k = 0; k < BM_COUNT; k++)
+        fprintf(csv, ",%s_mean,%s_sd,%s_ci95", bench_metric_names[k], bench_metric_names[k],
+                bench_metric_names[k]);
+    fprintf(csv, "\n");
+}
+
+// Unavailable metrics are left empty.
+void write_csv_row(FILE *csv, const bench_mode_t *mode, long size, long threads, long buffer,
+                   int failed, const bench_stat_t *st) {
+    fprintf(csv, "%s,%ld,%ld,%ld,%d,%d", mode->type, size, threads, buffer, st[BM_THROUGHPUT].n,
+            failed);
+    for (int k = 0; k < BM_COUNT; k++) {
+        if (st[k].n == 0) fprintf(csv, ",,,");
+        else fprintf(csv, ",%.6g,%.6g,%.6g", st[k].mean, st[k].sd, st[k].ci95);
+    }
+    fprintf(csv, "\n");
+    fflush(csv);
+}
+
+void write_json_cell(FILE *json, const bench_mode_t *mode, long size, long threads, long buffer,
+                     int failed, const bench_stat_t *st, double (*runs)[BM_COUNT], int run_count) {
+    static int written = 0; // Cells so far: all but the first need a comma
+    fprintf(json, "%s\n    {\"type\": \"%s\", \"mode\": \"%s\", \"msg_size\": %ld, \"threads\": %ld, "
+            "\"buffer\": %ld, \"runs\": %d, \"failed\": %d, \"metrics\": {", written++ ? "," : "",
+            mode->type, mode->name, size, threads, buffer, st[BM_THROUGHPUT].n, failed);
+    for (int k = 0; k < BM_COUNT; k++) {
+        fprintf(json, "%s\n      \"%s\": ", k ? "," : "", bench_metric_names[k]);
+        if (st[k].n == 0) {
+            fprintf(json, "null");
+            continue;
+        }
+        fprintf(json, "{\"n\": %d, \"mean\": %.6g, \"sd\": %.6g, \"ci95\": %.6g, \"values\": [",
+                st[k].n, st[k].mean, st[k].sd, st[k].ci95);
+        for (int r = 0, out = 0; r < run_count; r++)
+            if (runs[r][k] >= 0) fprintf(json, "%s%.6g", out++ ? ", " : "", runs[r][k]);
+        fprintf(json, "]}");
+    }
+    fprintf(json, "\n    }}");
+    fflush(json);
+}
+
+// ---------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------
+
+// One cell: fresh server, warmup, repetitions. Returns 0 if any run counted,
+// with the mean throughput in *gbps.
+int run_cell(const bench_mode_t *mode, long size, long threads, long buffer, FILE *csv,
+             FILE *json, double *gbps) {
+    int log_fd = open(bench_config.log_path, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (log_fd < 0) {
+        perror(bench_config.log_path);
+        return -1;
+    }
+    pid_t server = start_server(mode->server, bench_config.server_flags, log_fd);
+    if (server < 0) {
+        close(log_fd);
+        return -1;
+    }
+
+    char *out = malloc(BENCH_CLIENT_OUT);
+    double (*runs)[BM_COUNT] = calloc(bench_config.reps, sizeof(*runs));
+    int failed = 0;
+
+    for (int i = 0; i < bench_config.warmup; i++)
+        run_client(mode, size, threads, buffer, out, BENCH_CLIENT_OUT);
+
+    for (int r = 0; r < bench_config.reps; r++) {
+        off_t from = lseek(log_fd, 0, SEEK_END);
+        int status = run_client(mode, size, threads, buffer, out, BENCH_CLIENT_OUT);
+        parse_client(out, runs[r]);
+        parse_server_perf(log_fd, from, runs[r]);
+        if (status != 0 || runs[r][BM_THROUGHPUT] <= 0) {
+            for (int k = 0; k < BM_COUNT; k++) runs[r][k] = -1; // Excluded
+            failed++;
+        }
+    }
+    stop_server(server);
+    close(log_fd);
+
+    bench_stat_t st[BM_COUNT];
+    for (int k = 0; k < BM_COUNT; k++) {
+        double v[bench_config.reps];
+        for (int r = 0; r < bench_config.reps; r++) v[r] = runs[r][k];
+        bench_stat(v, bench_config.reps, &st[k]);
+    }
+
+    const bench_stat_t *tp = &st[BM_THROUGHPUT];
+    printf("%-15s %8ld B x %-4ld", mode->type, size, threads);
+    if (bench_config.buffer_count > 1 || buffer > 0) printf(" buf %-8ld", buffer);
+    printf(" %9.3f +- %7.3f Gbps (sd %.3f, %4.1f%%, n=%d%s)", tp->mean, tp->ci95, tp->sd, tp->mean > 0 ? 100 * tp->sd / tp->mean : 0.0,
+           tp->n, failed ? ", some runs failed" : "");
+    if (st[BM_P99].n) printf("  p99 %.2f +- %.2f us", st[BM_P99].mean, st[BM_P99].ci95);
+    printf("\n");
+    fflush(stdout);
+
+    write_csv_row(csv, mode, size, threads, buffer, failed, st);
+    write_json_cell(json, mode, size, threads, buffer, failed, st, runs, bench_config.reps);
+    free(runs);
+    free(out);
+    *gbps = tp->mean;
+    return tp->n > 0 ? 0 : -1;
+}
+
+void bench_interrupted(int sig) {
+    (void)sig;
+    if (bench_server_pid > 0) kill(bench_server_pid, SIGKILL);
+    _exit(EXIT_FAILURE);
+}
+
+// "1024,32768" -> values[]. Returns the count, -1 on a bad list.
+int parse_list(const char *text, long *values, int max) {
+    int count = 0;
+    char buf[512], *save = NULL;
+    snprintf(buf, sizeof(buf), "%s", text);
+    for (char *w = strtok_r(buf, ",", &save); w; w = strtok_r(NULL, ",", &save)) {
+        if (count == max || atol(w) <= 0) return -1;
+        values[count++] = atol(w);
+    }
+    return count > 0 ? count : -1;
+}
+
+// -b: "auto", or sizes with K/M suffixes where 0 / "default" = kernel default.
+int parse_buffers(const char *text, long *values, int max) {
+    if (strcmp(text, "auto") == 0) text = "0,64K,256K,1M,4M,16M";
+    int count = 0;
+    char buf[512], *save = NULL;
+    snprintf(buf, sizeof(buf), "%s", text);
+    for (char *w = strtok_r(buf, ",", &save); w; w = strtok_r(NULL, ",", &save)) {
+        long long v = strcmp(w, "default") == 0 ? 0 : tune_parse_size(w);
+        if (count == max || v < 0 || v > INT32_MAX) return -1;
+        values[count++] = (long)v;
+    }
+    return count > 0 ? count : -1;
+}
+
+const bench_mode_t *find_mode(const char *name) {
+    for (int i = 0; i < BENCH_MODE_COUNT; i++)
+        if (strcmp(bench_modes[i].name, name) == 0 || strcmp(bench_modes[i].type, name) == 0)
+            return &bench_modes[i];
+    return NULL;
+}
+
+void print_bench_usage(const char *prog) {
+    printf("Usage: %s [-m modes] [-s sizes] [-t threads] [-d duration] [-W warmup]\n"
+           "       [-w warmups] [-n reps] [-b buffers|auto] [-S \"server flags\"] [-C \"client flags\"]\n"
+           "       [-o csv] [-j json] [-l log]\n", prog);
+    printf("  -m L  Comma-separated modes (default two-copy,one-copy,zero-copy):\n       ");
+    for (int i = 0; i < BENCH_MODE_COUNT; i++) printf(" %s", bench_modes[i].name);
+    printf("\n");
+    printf("  -s L  Message sizes in bytes (default 1024,32768,131072,1048576)\n");
+    printf("  -t L  Thread counts (default 1,2,4,8)\n");
+    printf("  -d D  Measurement window per run: seconds (2, 1.5s) or 500ms (default 1s)\n");
+    printf("  -W D  Warmup inside every run, excluded by client and server (default 250ms)\n");
+    printf("  -w N  Warmup runs per cell, discarded (default 1)\n");
+    printf("  -n N  Measured repetitions per cell (default 5)\n");
+    printf("  -b L  Socket buffer sizes to sweep per cell (client -T sndbuf=X,rcvbuf=X, K/M\n"
+           "        suffixes, 0 = kernel default), then report the best; auto = 0,64K,256K,\n"
+           "        1M,4M,16M (default: kernel default only)\n");
+    printf("  -S F  Extra server flags, e.g. \"-e 4\" (the driver always adds -P)\n");
+    printf("  -C F  Extra client flags, e.g. \"-s trunc\"\n");
+    printf("  -o F  CSV summary (default MT25073_bench.csv)\n");
+    printf("  -j F  JSON summary with raw values (default MT25073_bench.json)\n");
+    printf("  -l F  Server log of the current cell (default MT25073_bench_server.log)\n");
+}
+
+int main(int argc, char *argv[]) {
+    bench_config_t *cfg = &bench_config;
+    char modes_text[256] = "two-copy,one-copy,zero-copy";
+    cfg->size_count = parse_list("1024,32768,131072,1048576", cfg->sizes, BENCH_MAX_LIST);
+    cfg->thread_count = parse_list("1,2,4,8", cfg->threads, BENCH_MAX_LIST);
+    cfg->buffer_count = 1; // buffers[0] = 0: kernel default
+    cfg->duration_ms = 1000;
+    cfg->run_warmup_ms = 250;
+    cfg->warmup = 1;
+    cfg->reps = 5;
+    cfg->csv_path = "MT25073_bench.csv";
+    cfg->json_path = "MT25073_bench.json";
+    cfg->log_path = "MT25073_bench_server.log";
+
+    int c;
+    while ((c = getopt(argc, argv, "m:s:t:d:W:w:n:b:S:C:o:j:l:h")) != -1) {
+        switch (c) {
+        case 'm': snprintf(modes_text, sizeof(modes_text), "%s", optarg); break;
+        case 's': cfg->size_count = parse_list(optarg, cfg->sizes, BENCH_MAX_LIST); break;
+        case 't': cfg->thread_count = parse_list(optarg, cfg->threads, BENCH_MAX_LIST); break;
+        case 'd': cfg->duration_ms = parse_duration_ms(optarg); break;
+        case 'W': cfg->run_warmup_ms = parse_duration_ms(optarg); break;
+        case 'w': cfg->warmup = atoi(optarg); break;
+        case 'n': cfg->reps = atoi(optarg); break;
+        case 'b': cfg->buffer_count = parse_buffers(optarg, cfg->buffers, BENCH_MAX_LIST); break;
+        case 'S': cfg->server_flags = optarg; break;
+        case 'C': cfg->client_flags = optarg; break;
+        case 'o': cfg->csv_path = optarg; break;
+        case 'j': cfg->json_path = optarg; break;
+        case 'l': cfg->log_path = optarg; break;
+        default:
+            print_bench_usage(argv[0]);
+            return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (cfg->size_count < 0 || cfg->thread_count < 0 || cfg->buffer_count < 0 ||
+        cfg->duration_ms <= 0 || cfg->run_warmup_ms < 0 || cfg->warmup < 0 || cfg->reps <= 0) {
+        print_bench_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    char *save = NULL;
+    for (char *w = strtok_r(modes_text, ",", &save); w; w = strtok_r(NULL, ",", &save)) {
+        const bench_mode_t *mode = find_mode(w);
+        if (!mode || cfg->mode_count == BENCH_MODE_COUNT) {
+            fprintf(stderr, "Unknown mode '%s'\n", w);
+            print_bench_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        cfg->modes[cfg->mode_count++] = mode;
+    }
+
+    FILE *csv = fopen(cfg->csv_path, "w");
+    FILE *json = fopen(cfg->json_path, "w");
+    if (!csv || !json) {
+        perror(!csv ? cfg->csv_path : cfg->json_path);
+        return EXIT_FAILURE;
+    }
+    signal(SIGINT, bench_interrupted);
+    signal(SIGTERM, bench_interrupted);
+
+    printf("Bench: %d warmup + %d measured runs of %ld ms (after %ld ms warmup) per cell, "
+           "95%% CI of the mean\n", cfg->warmup, cfg->reps, cfg->duration_ms, cfg->run_warmup_ms);
+    write_csv_header(csv);
+    fprintf(json, "{\n  \"duration_ms\": %ld, \"run_warmup_ms\": %ld, \"warmup\": %d, "
+            "\"repetitions\": %d,\n  \"server_flags\": \"%s\", \"client_flags\": \"%s\",\n  \"cells\": [",
+            cfg->duration_ms, cfg->run_warmup_ms, cfg->warmup, cfg->reps, cfg->server_flags ? cfg->server_flags : "",
+            cfg->client_flags ? cfg->client_flags : "");
+
+    // Best buffer size per (mode, size, threads), for the -b summary
+    int best_count = cfg->mode_count * cfg->size_count * cfg->thread_count;
+    long *best_buffer = calloc(best_count, sizeof(long));
+    double *best_gbps = calloc(best_count, sizeof(double));
+    double *default_gbps = calloc(best_count, sizeof(double));
+
+    int cells = 0, bad = 0;
+    for (int m = 0; m < cfg->mode_count; m++)
+        for (int s = 0; s < cfg->size_count; s++)
+            for (int t = 0; t < cfg->thread_count; t++) {
+                int i = (m * cfg->size_count + s) * cfg->thread_count + t;
+                for (int b = 0; b < cfg->buffer_count; b++) {
+                    double gbps = 0;
+                    if (run_cell(cfg->modes[m], cfg->sizes[s], cfg->threads[t], cfg->buffers[b],
+                                 csv, json, &gbps) != 0) {
+                        bad++;
+                        continue;
+                    }
+                    cells++;
+                    if (cfg->buffers[b] == 0) default_gbps[i] = gbps;
+                    if (gbps > best_gbps[i]) best_gbps[i] = gbps, best_buffer[i] = cfg->buffers[b];
+                }
+            }
+
+    if (cfg->buffer_count > 1) {
+        printf("Bench: best socket buffer per cell (0 = kernel default)\n");
+        for (int m = 0; m < cfg->mode_count; m++)
+            for (int s = 0; s < cfg->size_count; s++)
+                for (int t = 0; t < cfg->thread_count; t++) {
+                    int i = (m * cfg->size_count + s) * cfg->thread_count + t;
+                    if (best_gbps[i] <= 0) continue;
+                    printf("%-15s %8ld B x %-4ld buf %-8ld %9.3f Gbps", cfg->modes[m]->type,
+                           cfg->sizes[s], cfg->threads[t], best_buffer[i], best_gbps[i]);
+                    if (default_gbps[i] > 0)
+                        printf("  (%+.1f%% vs default)",
+                               100 * (best_gbps[i] - default_gbps[i]) / default_gbps[i]);
+                    printf("\n");
+                }
+    }
+    free(best_buffer);
+    free(best_gbps);
+    free(default_gbps);
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(csv);
+    fclose(json);
+    printf("Bench: %d cells measured, %d failed. Results in %s and %s\n", cells, bad,
+           cfg->csv_path, cfg->json_path);
+    return bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -6,57 +6,185 @@
 # 1. SETUP PARAMETERS
 # We need 4 distinct message sizes (bytes) and 4 thread counts.
 SIZES=(1024 32768 131072 1048576) # 1KB, 32KB, 128KB, 1MB
-THREADS=(1 2 4 8)
-DURATION=5
+THREADS=(${THREADS:-1 2 4 8})
+# DURATION: measurement window per cell, seconds (5, 1.5) or ms (500ms).
+# WARMUP: run this long first, excluded by client and server (e.g. 250ms).
+DURATION=${DURATION:-5}
+WARMUP=${WARMUP:-0}
 OUTPUT_FILE="MT25073_measurements.csv"
+# PINNED=1: pre-spawned server workers pinned to CPUs 0..T-1 with CPU-steered
+# SO_REUSEPORT listeners, and client thread i pinned to CPU i.
+PINNED=${PINNED:-0}
+# PINGPONG=1: closed-loop request/response instead of streaming, with
+# OUTSTANDING requests in flight per connection. Percentiles are then RTTs.
+PINGPONG=${PINGPONG:-0}
+OUTSTANDING=${OUTSTANDING:-1}
+# SINK=trunc|splice|zerocopy: how the client consumes data (default recv).
+# Compare against recv to see whether the client's copy limits throughput.
+SINK=${SINK:-recv}
+# UNIFIED=1: start server_unified once and let each client pick the transport
+# (-t) in its handshake; its -P counters are split per cell from its log.
+UNIFIED=${UNIFIED:-0}
+# FIELDS="8 64 512": field-count axis (fields per message, sent with client -f),
+# FIELD_LAYOUT=uniform|skewed for how the size is split. Shows where the
+# per-iovec cost of sendmsg() (A2/A3) overtakes the cost of stitching (A1).
+FIELD_COUNTS=(${FIELDS:-8})
+FIELD_LAYOUT=${FIELD_LAYOUT:-uniform}
+# BATCH=K|auto: server sends K messages per batch (-k), BATCH_MODE=coalesce|more|cork
+# (-B), BATCH_BUDGET=<us> latency budget for BATCH=auto (-L). Default: no batching.
+BATCH=${BATCH:-}
+BATCH_MODE=${BATCH_MODE:-coalesce}
+BATCH_BUDGET=${BATCH_BUDGET:-500}
+BATCH_FLAGS=""
+if [ -n "$BATCH" ]; then
+    BATCH_FLAGS="-k $BATCH -B $BATCH_MODE -L $BATCH_BUDGET"
+fi
+# FRAMED=crc|seq: per-message headers (client -F), verified with CRC32C (crc)
+# or headers only (seq). Adds the Goodput column: payload bytes of verified
+# frames, in Gbps. Needs SINK=recv.
+FRAMED=${FRAMED:-}
+# RATE=N[:poisson]: open loop, the server sends N messages/s per connection
+# (client -r); percentiles are then measured from the intended send times.
+# LOADS="50 80 95": after every closed-loop cell, rerun it open loop at these
+# percentages of the message rate it reached, with ARRIVALS=poisson|constant.
+# Shows how latency degrades with load. Both need streaming (no PINGPONG).
+RATE=${RATE:-}
+LOADS=(${LOADS:-})
+ARRIVALS=${ARRIVALS:-poisson}
+# CLIENT_LOOPS=N: the client drives all connections of a cell from N epoll
+# loops (client -e), so the thread axis can be a fan-in of thousands of
+# connections, e.g. THREADS="1000 10000" CLIENT_LOOPS=4 SERVER_LOOPS=4.
+# SERVER_LOOPS=N runs the servers on N epoll loops (-e); A4 cannot.
+# With PINNED=1 the loops, not the connections, get one CPU each.
+CLIENT_LOOPS=${CLIENT_LOOPS:-}
+SERVER_LOOPS=${SERVER_LOOPS:-}
+# IPC=unix|pipe: the same matrix over a Unix domain socket, or with the
+# messages written into a pipe (servers -i unix, clients -i $IPC). Compare
+# with the default tcp run to separate TCP/IP stack cost from copying.
+# Pipes need a blocking server engine (no SERVER_LOOPS); A4 is skipped.
+IPC=${IPC:-tcp}
+IPC_SERVER_FLAGS=""
+if [ "$IPC" != "tcp" ]; then
+    IPC_SERVER_FLAGS="-i unix"
+fi
 
 # 2. COMPILE EVERYTHING
 echo "--- Compiling Programs ---"
-gcc MT25073_Part_A1_Server.c -o server_a1 -lpthread
-gcc MT25073_Part_A1_Client.c -o client_a1 -lpthread
-gcc MT25073_Part_A2_Server.c -o server_a2 -lpthread
-gcc MT25073_Part_A2_Client.c -o client_a2 -lpthread
-gcc MT25073_Part_A3_Server.c -o server_a3 -lpthread
-gcc MT25073_Part_A3_Client.c -o client_a3 -lpthread
+gcc MT25073_Part_A1_Server.c -o server_a1 -lpthread -lm
+gcc MT25073_Part_A1_Client.c -o client_a1 -lpthread -lm
+gcc MT25073_Part_A2_Server.c -o server_a2 -lpthread -lm
+gcc MT25073_Part_A2_Client.c -o client_a2 -lpthread -lm
+gcc MT25073_Part_A3_Server.c -o server_a3 -lpthread -lm
+gcc MT25073_Part_A3_Client.c -o client_a3 -lpthread -lm
+gcc MT25073_Part_A4_Server.c -o server_a4 -lpthread -lm
+gcc MT25073_Part_A4_Client.c -o client_a4 -lpthread -lm
+gcc MT25073_Part_A5_Server.c -o server_a5 -lpthread -lm
+gcc MT25073_Part_A5_Client.c -o client_a5 -lpthread -lm
+gcc MT25073_Part_A6_Server.c -o server_a6 -lpthread -lm
+gcc MT25073_Part_A6_Client.c -o client_a6 -lpthread -lm
+gcc MT25073_Part_A_Unified_Server.c -o server_unified -lpthread -lm
 
 # Initialize CSV Header
-# Format: Type,MsgSize,Threads,Throughput(Gbps),Latency(us),Cycles,L1_Misses,LLC_Misses,Context_Switches
-echo "Type,MsgSize,Threads,Throughput,Latency,Cycles,L1_Misses,LLC_Misses,CS" > $OUTPUT_FILE
+# Format: Type,MsgSize,Threads,Throughput(Gbps),Latency(us),Cycles,L1_Misses,LLC_Misses,Context_Switches,
+#         P50,P90,P99,P99.9,Max (us, per-message latency histogram from the client),
+#         Fields (fields per message), Goodput (Gbps of verified payload, FRAMED only),
+#         Rate (open-loop target, msg/s per connection; empty = closed loop),
+#         Instructions, IPC (tcp | unix | pipe). Counters are the server's own (-P), summed over its
+#         connections and limited to the transfer loops; empty = not available.
+echo "Type,MsgSize,Threads,Throughput,Latency,Cycles,L1_Misses,LLC_Misses,CS,P50,P90,P99,P999,Max,Fields,Goodput,Rate,Instructions,IPC" > $OUTPUT_FILE
+
+# Sum one counter (cycles, L1D-misses, ...) over the server's "Perf:" lines
+# from line LOG_START of SERVER_LOG on. A counter the machine does not offer
+# is logged as n/a and left empty in the CSV.
+perf_sum() {
+    tail -n +$LOG_START $SERVER_LOG | grep "Perf:" |
+        awk -v key="$1=" '{ for (i = 1; i <= NF; i++)
+                                if (index($i, key) == 1) {
+                                    v = substr($i, length(key) + 1)
+                                    if (v != "n/a") { sum += v; seen = 1 }
+                                } }
+                          END { if (seen) printf "%.0f", sum }'
+}
 
 # Function to run one experiment
-run_test() {
-    TYPE=$1      # A1, A2, or A3
-    SERVER_BIN=$2
+run_cell() {
+    TYPE=$1      # A1 ... A6
+    SERVER_BIN=$2  # May carry server flags, e.g. "server_a5 -m splice"
     CLIENT_BIN=$3
     SIZE=$4
     THREAD=$5
+    TRANSPORT=$6   # Client -t name, used when UNIFIED=1
+    FIELD_COUNT=$7
+    RATE_SPEC=$8   # Client -r argument, empty = closed loop
+    MSG_RATE=""    # Reached msg/s per connection (for LOADS)
 
-    echo "Running $TYPE: Size=$SIZE, Threads=$THREAD..."
+    # Every field holds at least one byte
+    if [ "$FIELD_COUNT" -gt "$SIZE" ]; then
+        echo "Skipping $TYPE: $FIELD_COUNT fields do not fit in $SIZE bytes"
+        return
+    fi
 
-    # Start Server with perf in background
-    # We measure: cycles, L1-dcache-load-misses, LLC-load-misses, context-switches
-    # 2>&1 redirects stderr (perf output) to a temp file
-    sudo perf stat -e cycles,L1-dcache-load-misses,LLC-load-misses,cs \
-        -o perf_output.txt ./$SERVER_BIN > server_log.txt 2>&1 &
-    
-    SERVER_PID=$!
-    
-    # Give server a moment to start
-    sleep 1
+    echo "Running $TYPE: Size=$SIZE, Threads=$THREAD, Fields=$FIELD_COUNT${RATE_SPEC:+, Rate=$RATE_SPEC}..."
+
+    SERVER_FLAGS="$BATCH_FLAGS $IPC_SERVER_FLAGS"
+    CLIENT_FLAGS="-i $IPC -W $WARMUP"
+    CPUS=$THREAD
+    if [ -n "$CLIENT_LOOPS" ]; then
+        CLIENT_FLAGS="$CLIENT_FLAGS -e $CLIENT_LOOPS"
+        CPUS=$CLIENT_LOOPS
+    fi
+    if [ "$PINNED" -eq 1 ]; then
+        SERVER_FLAGS="$SERVER_FLAGS -w $CPUS -A"
+        CLIENT_FLAGS="$CLIENT_FLAGS -c 0-$((CPUS - 1))"
+    elif [ -n "$SERVER_LOOPS" ]; then
+        SERVER_FLAGS="$SERVER_FLAGS -e $SERVER_LOOPS"
+    fi
+    if [ "$PINGPONG" -eq 1 ]; then
+        CLIENT_FLAGS="$CLIENT_FLAGS -p -o $OUTSTANDING"
+    fi
+    CLIENT_FLAGS="$CLIENT_FLAGS -s $SINK -f $FIELD_COUNT:$FIELD_LAYOUT"
+    WIRE_SIZE=$SIZE
+    if [ -n "$FRAMED" ]; then
+        CLIENT_FLAGS="$CLIENT_FLAGS -F $FRAMED"
+        WIRE_SIZE=$((SIZE + 24)) # frame_header_t
+    fi
+    if [ -n "$RATE_SPEC" ]; then
+        CLIENT_FLAGS="$CLIENT_FLAGS -r $RATE_SPEC"
+    fi
+
+    if [ "$UNIFIED" -eq 1 ]; then
+        # The server is already running (with -P): this cell's Perf lines
+        # are the ones its log gains while the client runs.
+        CLIENT_FLAGS="$CLIENT_FLAGS -t $TRANSPORT"
+        SERVER_LOG=unified_server_log.txt
+        LOG_START=$(($(wc -l < $SERVER_LOG) + 1))
+    else
+        # Start Server in background. -P: every connection (or epoll loop)
+        # reads its own hardware counters around its transfer loop and logs
+        # "Perf: cycles=N instructions=N L1D-misses=N LLC-misses=N cs=N ..."
+        ./$SERVER_BIN $SERVER_FLAGS -P > server_log.txt 2>&1 &
+        SERVER_PID=$!
+        SERVER_LOG=server_log.txt
+        LOG_START=1
+
+        # Give server a moment to start
+        sleep 1
+    fi
 
     # Run Client and capture output
-    CLIENT_OUTPUT=$(./$CLIENT_BIN $SIZE $THREAD $DURATION)
+    CLIENT_OUTPUT=$(./$CLIENT_BIN $CLIENT_FLAGS $SIZE $THREAD $DURATION)
 
     # Extract Throughput from Client Output
     # We look for the line "Throughput: X Gbps"
     THROUGHPUT=$(echo "$CLIENT_OUTPUT" | grep "Throughput:" | awk '{print $2}')
+    GOODPUT=$(echo "$CLIENT_OUTPUT" | grep "Goodput:" | awk '{print $2}')
     
     # Calculate Latency (Approximate: Time / Total Messages)
     # Total Bytes
     TOTAL_BYTES=$(echo "$CLIENT_OUTPUT" | grep "Total Bytes Received:" | awk '{print $4}')
     # Number of messages = Total Bytes / Msg Size
     if [ "$SIZE" -gt 0 ]; then
-        NUM_MSGS=$(echo "$TOTAL_BYTES / $SIZE" | bc)
+        NUM_MSGS=$(echo "$TOTAL_BYTES / $WIRE_SIZE" | bc)
     else
         NUM_MSGS=1
     fi
@@ -67,33 +195,55 @@ run_test() {
     # Avoid divide by zero
     if [ "$NUM_MSGS" -gt 0 ]; then
         LATENCY=$(echo "scale=2; ($TIME_TAKEN * 1000000) / $NUM_MSGS" | bc)
+        MSG_RATE=$(echo "$NUM_MSGS / $TIME_TAKEN / $THREAD" | bc)
     else
         LATENCY="0"
     fi
 
-    # Stop Server (SIGINT allows perf to print stats)
-    sudo kill -2 $SERVER_PID
-    wait $SERVER_PID 2>/dev/null
+    # Tail latency from the client's merged per-thread histograms
+    # Line format: "Msg Latency: p50=X p90=X p99=X p99.9=X max=X mean=X (us, n=N)"
+    # (labelled "RTT Latency:" in ping-pong mode)
+    LAT_LINE=$(echo "$CLIENT_OUTPUT" | grep -E "Msg Latency:|RTT Latency:")
+    P50=$(echo "$LAT_LINE" | sed -n 's/.*p50=\([0-9.]*\).*/\1/p')
+    P90=$(echo "$LAT_LINE" | sed -n 's/.*p90=\([0-9.]*\).*/\1/p')
+    P99=$(echo "$LAT_LINE" | sed -n 's/.*p99=\([0-9.]*\).*/\1/p')
+    P999=$(echo "$LAT_LINE" | sed -n 's/.*p99\.9=\([0-9.]*\).*/\1/p')
+    PMAX=$(echo "$LAT_LINE" | sed -n 's/.*max=\([0-9.]*\).*/\1/p')
 
-    # Extract Perf Stats from perf_output.txt
-    # We use basic grep/awk to pull the numbers. 
-    # Note: Perf numbers often have commas (1,234), we remove them.
-    CYCLES=$(grep "cycles" perf_output.txt | awk '{print $1}' | tr -d ',')
-    L1_MISS=$(grep "L1-dcache-load-misses" perf_output.txt | awk '{print $1}' | tr -d ',')
-    LLC_MISS=$(grep "LLC-load-misses" perf_output.txt | awk '{print $1}' | tr -d ',')
-    CS=$(grep "cs" perf_output.txt | awk '{print $1}' | tr -d ',')
+    # Stop Server (SIGINT; the unified server keeps running for the next cell)
+    if [ "$UNIFIED" -ne 1 ]; then
+        kill -2 $SERVER_PID
+        wait $SERVER_PID 2>/dev/null
+    fi
 
-    # Handle empty perf data (if perf failed)
-    CYCLES=${CYCLES:-0}
-    L1_MISS=${L1_MISS:-0}
-    LLC_MISS=${LLC_MISS:-0}
-    CS=${CS:-0}
+    # Sum the server's Perf lines for this cell
+    CYCLES=$(perf_sum cycles)
+    INSTRUCTIONS=$(perf_sum instructions)
+    L1_MISS=$(perf_sum L1D-misses)
+    LLC_MISS=$(perf_sum LLC-misses)
+    CS=$(perf_sum cs)
 
     # Save to CSV
-    echo "$TYPE,$SIZE,$THREAD,$THROUGHPUT,$LATENCY,$CYCLES,$L1_MISS,$LLC_MISS,$CS" >> $OUTPUT_FILE
+    echo "$TYPE,$SIZE,$THREAD,$THROUGHPUT,$LATENCY,$CYCLES,$L1_MISS,$LLC_MISS,$CS,$P50,$P90,$P99,$P999,$PMAX,$FIELD_COUNT,$GOODPUT,${RATE_SPEC%%:*},$INSTRUCTIONS,$IPC" >> $OUTPUT_FILE
     
     # Cleanup temp files
-    rm -f perf_output.txt server_log.txt
+    rm -f server_log.txt
+}
+
+# One cell of the matrix: at RATE (closed loop if unset), then at each of
+# LOADS percent of the rate the closed-loop run reached.
+run_test() {
+    run_cell "$@" "$RATE"
+    if [ ${#LOADS[@]} -eq 0 ] || [ -n "$RATE" ] || [ -z "$MSG_RATE" ]; then
+        return
+    fi
+    SATURATION=$MSG_RATE
+    for L in "${LOADS[@]}"; do
+        R=$((SATURATION * L / 100))
+        if [ "$R" -gt 0 ]; then
+            run_cell "$@" "$R:$ARRIVALS"
+        fi
+    done
 }
 
 # 3. RUN LOOPS
@@ -101,27 +251,82 @@ run_test() {
 # You can adjust this logic, but usually we iterate everything.
 # To save time, let's do a full matrix as required.
 
+if [ "$UNIFIED" -eq 1 ]; then
+    UNIFIED_FLAGS="$BATCH_FLAGS $IPC_SERVER_FLAGS -P"
+    if [ "$PINNED" -eq 1 ]; then
+        MAX_T=$(printf "%s\n" "${THREADS[@]}" | sort -n | tail -1)
+        UNIFIED_FLAGS="$UNIFIED_FLAGS -w ${CLIENT_LOOPS:-$MAX_T} -A"
+    elif [ -n "$SERVER_LOOPS" ]; then
+        UNIFIED_FLAGS="$UNIFIED_FLAGS -e $SERVER_LOOPS"
+    fi
+    ./server_unified $UNIFIED_FLAGS > unified_server_log.txt 2>&1 &
+    UNIFIED_PID=$!
+    sleep 1
+fi
+
 # A1 Tests
 for S in "${SIZES[@]}"; do
     for T in "${THREADS[@]}"; do
-        run_test "TwoCopy" "server_a1" "client_a1" $S $T
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "TwoCopy" "server_a1" "client_a1" $S $T two-copy $F
+        done
     done
 done
 
 # A2 Tests
 for S in "${SIZES[@]}"; do
     for T in "${THREADS[@]}"; do
-        run_test "OneCopy" "server_a2" "client_a2" $S $T
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "OneCopy" "server_a2" "client_a2" $S $T one-copy $F
+        done
     done
 done
 
 # A3 Tests
 for S in "${SIZES[@]}"; do
     for T in "${THREADS[@]}"; do
-        run_test "ZeroCopy" "server_a3" "client_a3" $S $T
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "ZeroCopy" "server_a3" "client_a3" $S $T zero-copy $F
+        done
     done
 done
 
+# A4 Tests (io_uring sends need a socket, not a pipe)
+for S in "${SIZES[@]}"; do
+    [ "$IPC" = "pipe" ] && break
+    for T in "${THREADS[@]}"; do
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "IoUring" "server_a4" "client_a4" $S $T io_uring $F
+        done
+    done
+done
+
+# A5 Tests (same matrix, kernel-internal paths from a memfd)
+for S in "${SIZES[@]}"; do
+    for T in "${THREADS[@]}"; do
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "Sendfile" "server_a5 -m sendfile" "client_a5" $S $T sendfile $F
+            run_test "Splice" "server_a5 -m splice" "client_a5" $S $T splice $F
+        done
+    done
+done
+
+# A6 Tests (per-message choice between A1/A2/A3: size thresholds, then online calibration)
+for S in "${SIZES[@]}"; do
+    for T in "${THREADS[@]}"; do
+        for F in "${FIELD_COUNTS[@]}"; do
+            run_test "AdaptiveStatic" "server_a6 -m static" "client_a6" $S $T adaptive $F
+            run_test "AdaptiveOnline" "server_a6 -m online" "client_a6" $S $T adaptive-online $F
+        done
+    done
+done
+
+if [ "$UNIFIED" -eq 1 ]; then
+    kill -2 $UNIFIED_PID
+    wait $UNIFIED_PID 2>/dev/null
+    rm -f unified_server_log.txt
+fi
+
 echo "------------------------------------------------"
 echo "Experiments Complete. Results saved to $OUTPUT_FILE"
 echo "------------------------------------------------"
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_E_MetricsTop.c
+ * Part: E (Tools)
+ * Description: Live view of a running server's shared-memory metrics
+ * (MT25073_Part_A_Metrics.h). Every interval it snapshots all workers'
+ * counters and prints the rates since the previous snapshot:
+ *   Gbps, msg/s    : what the server pushed into its sockets
+ *   calls/s, B/call: send-path syscalls, and bytes each one moved
+ *   EAGAIN/s       : epoll engine waits for a full socket
+ *   ENOBUFS/s      : A3 zero-copy refused for lack of notification memory
+ *   zc/s, copied%  : zero-copy completions, and the share the kernel copied
+ *   conn/s, workers: new connections, workers that currently own a slot
+ * The server is never stopped or slowed down: the reader only maps the file.
+ * It exits when the server process is gone.
+ *
+ * Usage: ./metrics_top [-i <ms>] [-n <count>] [-a] [file]
+ */
+
+#include "MT25073_Part_A_Common.h"
+#include "MT25073_Part_A_Metrics.h"
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+typedef struct {
+    uint64_t counters[METRICS_SLOTS][METRIC_COUNT];
+    uint64_t total[METRIC_COUNT];
+    uint64_t ns;
+} metrics_snapshot_t;
+
+// Map the server's region read-only. Returns NULL until a server created it.
+const metrics_header_t *top_map(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    size_t len = metrics_region_size(METRICS_SLOTS);
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < len) {
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const metrics_header_t *hdr = (const metrics_header_t *)base;
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != METRICS_MAGIC ||
+        hdr->version != METRICS_VERSION || hdr->slot_size != sizeof(metrics_slot_t) ||
+        hdr->slot_count != METRICS_SLOTS) {
+        fprintf(stderr, "%s: not a version %d metrics file of this build\n", path, METRICS_VERSION);
+        exit(EXIT_FAILURE);
+    }
+    return hdr;
+}
+
+void top_snapshot(const metrics_slot_t *slots, metrics_snapshot_t *snap) {
+    memset(snap->total, 0, sizeof(snap->total));
+    for (int i = 0; i < METRICS_SLOTS; i++) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            uint64_t v = __atomic_load_n(&slots[i].counters[m], __ATOMIC_RELAXED);
+            snap->counters[i][m] = v;
+            snap->total[m] += v;
+        }
+    }
+    snap->ns = run_now_ns();
+}
+
+// One line of rates from the counter differences d[] over `secs` seconds.
+void top_print_rates(const char *label, const uint64_t *d, double secs) {
+    double calls = d[METRIC_SYSCALLS];
+    printf("%-10s %8.3f %10.0f %10.0f %8.0f %9.0f %9.0f %10.0f %7.1f %7.0f",
+           label, d[METRIC_BYTES] * 8 / secs / 1e9, d[METRIC_MESSAGES] / secs, calls / secs,
+           calls ? d[METRIC_BYTES] / calls : 0.0, d[METRIC_EAGAIN] / secs,
+           d[METRIC_ENOBUFS] / secs, d[METRIC_ZC_DONE] / secs,
+           d[METRIC_ZC_DONE] ? 100.0 * d[METRIC_ZC_COPIED] / d[METRIC_ZC_DONE] : 0.0,
+           d[METRIC_CONNECTIONS] / secs);
+}
+
+void top_print_header(void) {
+    printf("%-10s %8s %10s %10s %8s %9s %9s %10s %7s %7s %s\n", "time(s)", "Gbps", "msg/s",
+           "calls/s", "B/call", "EAGAIN/s", "ENOBUFS/s", "zc/s", "copied%", "conn/s", "workers");
+}
+
+void print_top_usage(const char *prog) {
+    printf("Usage: %s [-i <ms>] [-n <count>] [-a] [file]\n", prog);
+    printf("  -i ms  Interval between samples (default 1000)\n");
+    printf("  -n N   Stop after N samples (default: until the server exits)\n");
+    printf("  -a     Also print one line per worker that was busy in the interval\n");
+    printf("  file   Metrics file given to the server's -s (default %s)\n", METRICS_PATH);
+}
+
+int main(int argc, char *argv[]) {
+    int interval_ms = 1000, samples = 0, all = 0, c;
+    while ((c = getopt(argc, argv, "i:n:ah")) != -1) {
+        switch (c) {
+        case 'i':
+            interval_ms = atoi(optarg);
+            if (interval_ms <= 0) {
+                fprintf(stderr, "Interval must be positive\n");
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'n':
+            samples = atoi(optarg);
+            break;
+        case 'a':
+            all = 1;
+            break;
+        default:
+            print_top_usage(argv[0]);
+            return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    const char *path = optind < argc ? argv[optind] : METRICS_PATH;
+
+    const metrics_header_t *hdr = top_map(path);
+    if (!hdr) {
+        fprintf(stderr, "%s: no metrics (is a server running? see its -s option)\n", path);
+        return EXIT_FAILURE;
+    }
+    const metrics_slot_t *slots = (const metrics_slot_t *)(hdr + 1);
+    printf("Server: %s, pid %d, port %d\n", hdr->server, hdr->pid, hdr->port);
+
+    metrics_snapshot_t *prev = malloc(sizeof(metrics_snapshot_t));
+    metrics_snapshot_t *cur = malloc(sizeof(metrics_snapshot_t));
+    top_snapshot(slots, prev);
+
+    for (int n = 0; samples == 0 || n < samples; n++) {
+        struct timespec ts = { interval_ms / 1000, (interval_ms % 1000) * 1000000L };
+        nanosleep(&ts, NULL);
+        if (kill(hdr->pid, 0) < 0 && errno == ESRCH) {
+            printf("Server %d exited\n", hdr->pid);
+            break;
+        }
+        top_snapshot(slots, cur);
+
+        double secs = (cur->ns - prev->ns) / 1e9;
+        uint64_t d[METRIC_COUNT];
+        int workers = 0;
+        for (int i = 0; i < METRICS_SLOTS; i++) workers += __atomic_load_n(&slots[i].in_use, __ATOMIC_RELAXED);
+        for (int m = 0; m < METRIC_COUNT; m++) d[m] = cur->total[m] - prev->total[m];
+
+        if (n % 20 == 0 || all) top_print_header();
+        char label[32];
+        snprintf(label, sizeof(label), "%.1f", (cur->ns - hdr->start_ns) / 1e9);
+        top_print_rates(label, d, secs);
+        printf(" %d\n", workers);
+
+        // Per worker: who carries the load, who stalls (ramp-up, collapse)
+        for (int i = 0; all && i < METRICS_SLOTS; i++) {
+            uint64_t ds[METRIC_COUNT], busy = 0;
+            for (int m = 0; m < METRIC_COUNT; m++) {
+                ds[m] = cur->counters[i][m] - prev->counters[i][m];
+                busy |= ds[m];
+            }
+            if (!busy) continue;
+            char role[sizeof(slots[i].role) + 1];
+            memcpy(role, slots[i].role, sizeof(slots[i].role));
+            role[sizeof(slots[i].role)] = '\0';
+            snprintf(label, sizeof(label), "  %s", role);
+            top_print_rates(label, ds, secs);
+            printf(" tid %d\n", slots[i].tid);
+        }
+        fflush(stdout);
+
+        metrics_snapshot_t *t = prev;
+        prev = cur;
+        cur = t;
+    }
+
+    free(prev);
+    free(cur);
+    return EXIT_SUCCESS;
+}
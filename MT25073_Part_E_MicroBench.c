@@ -0,0 +1,325 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_E_MicroBench.c
+ * Part: E (Microbenchmarks)
+ * Description: Network-free microbenchmarks of the primitives the servers
+ * are built from. Every number in the measurements CSV includes TCP loopback;
+ * here each step is timed on its own, with the same code the servers run:
+ *   fill-malloc  : fill_complex_message() + free (one malloc per field)
+ *   fill-arena   : fill_complex_message_arena() (fields from a payload arena)
+ *   stitch       : A1's stitching loop with memcpy / the best streaming kernel
+ *   iov-setup    : build_iov_from_offset() + msghdr, IOV_MAX entries per call
+ *   write-null   : write() of the stitched message to /dev/null (a syscall
+ *                  that does not touch the data)
+ *   writev-null  : writev() of the fields to /dev/null (+ per-iovec cost)
+ *   send-unix    : send() of the stitched message into a socketpair, drained
+ *                  by a second thread (syscall + kernel copy, no TCP)
+ *   sendmsg-unix : sendmsg() of the fields into the socketpair (A2's path)
+ * across message sizes, field counts and field alignments (payload arena
+ * alignment; 1 = fields packed back to back at odd addresses). For each it
+ * reports ns per operation (one message), GB/s and bytes per TSC cycle, then
+ * splits A1's per-message cost:
+ *   user copy = stitch, syscall = write-null,
+ *   kernel copy + socket = send-unix - write-null (skb setup, copy, wakeup)
+ *
+ * Usage: ./micro_bench [-s sizes] [-f fields] [-a aligns] [-b bytes per measurement]
+ */
+
+#include "MT25073_Part_A_Server.h"
+#include <fcntl.h>
+
+#define MICRO_DEFAULT_BYTES (256UL << 20) // Moved per (cell, operation)
+#define MICRO_MIN_OPS       16
+#define MICRO_MAX_OPS       2000000
+#define MICRO_MAX_LIST      32
+#define MICRO_DRAIN_BUF     (1 << 20)
+
+// --- Time base: the TSC where there is one (as in stitch_bench) ---
+uint64_t micro_ticks(void) {
+#ifdef STITCH_X86
+    return __rdtsc();
+#else
+    return run_now_ns();
+#endif
+}
+
+double micro_now(void) {
+    return run_now_ns() / 1e9;
+}
+
+// Everything one (size, fields, align) cell works on.
+typedef struct {
+    size_t size;
+    int fields;
+    size_t align;
+    ComplexMessage msg;      // The payload, from `arena`
+    arena_t arena;
+    arena_t scratch_arena;   // fill-arena rebuilds into this one
+    char *stitched;          // A1 scratch buffer (64-byte aligned)
+    struct iovec *iov;       // IOV_MAX entries
+    const stitch_kernel_t *kernel;
+    int null_fd;
+    int unix_fd;             // Sending end of the socketpair
+} micro_cell_t;
+
+typedef int (*micro_op_fn)(micro_cell_t *cell); // One message; < 0 on error
+
+int op_fill_malloc(micro_cell_t *cell) {
+    ComplexMessage m;
+    if (fill_complex_message(&m, cell->size, cell->fields, FIELDS_UNIFORM) != 0) return -1;
+    free_complex_message(&m);
+    return 0;
+}
+
+int op_fill_arena(micro_cell_t *cell) {
+    ComplexMessage m;
+    cell->scratch_arena.used = 0; // A fresh payload arena every time
+    if (fill_complex_message_arena(&m, cell->size, cell->fields, FIELDS_UNIFORM,
+                                   &cell->scratch_arena) != 0)
+        return -1;
+    free_complex_message_arena(&m, &cell->scratch_arena);
+    return 0;
+}
+
+// two_copy_send()'s loop, with one kernel for the whole message.
+void stitch_with(micro_cell_t *cell, stitch_copy_fn copy) {
+    size_t offset = 0;
+    for (int i = 0; i < cell->msg.count; i++) {
+        copy(cell->stitched + offset, cell->msg.fields[i], cell->msg.sizes[i]);
+        offset += cell->msg.sizes[i];
+    }
+    if (copy != stitch_copy_memcpy) stitch_fence();
+}
+
+int op_stitch_memcpy(micro_cell_t *cell) {
+    stitch_with(cell, stitch_copy_memcpy);
+    return 0;
+}
+
+int op_stitch_kernel(micro_cell_t *cell) {
+    stitch_with(cell, cell->kernel->copy);
+    return 0;
+}
+
+// Every chunk of IOV_MAX entries the servers would build for one message.
+int op_iov_setup(micro_cell_t *cell) {
+    size_t offset = 0;
+    int more = 1;
+    while (more) {
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = cell->iov;
+        mh.msg_iovlen = build_iov_from_offset(&cell->msg, offset, cell->iov, IOV_MAX, &more);
+        for (size_t i = 0; i < mh.msg_iovlen; i++) offset += cell->iov[i].iov_len;
+        __asm__ volatile("" : : "r"(&mh) : "memory"); // Keep the stores
+    }
+    return 0;
+}
+
+// Write the whole message to `fd` (stitched or as iovecs), resuming partial writes.
+int write_message(int fd, micro_cell_t *cell, int vectored) {
+    size_t offset = 0;
+    while (offset < cell->size) {
+        ssize_t n;
+        if (vectored) {
+            int more;
+            int cnt = build_iov_from_offset(&cell->msg, offset, cell->iov, IOV_MAX, &more);
+            struct msghdr mh;
+            memset(&mh, 0, sizeof(mh));
+            mh.msg_iov = cell->iov;
+            mh.msg_iovlen = cnt;
+            n = fd == cell->null_fd ? writev(fd, cell->iov, cnt)
+                                    : sendmsg(fd, &mh, more ? MSG_MORE : 0);
+        } else {
+            n = fd == cell->null_fd ? write(fd, cell->stitched + offset, cell->size - offset)
+                                    : send(fd, cell->stitched + offset, cell->size - offset, 0);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        offset += n;
+    }
+    return 0;
+}
+
+int op_write_null(micro_cell_t *cell) { return write_message(cell->null_fd, cell, 0); }
+int op_writev_null(micro_cell_t *cell) { return write_message(cell->null_fd, cell, 1); }
+int op_send_unix(micro_cell_t *cell) { return write_message(cell->unix_fd, cell, 0); }
+int op_sendmsg_unix(micro_cell_t *cell) { return write_message(cell->unix_fd, cell, 1); }
+
+#define OP_FILL_MALLOC   0
+#define OP_FILL_ARENA    1
+#define OP_STITCH_MEMCPY 2
+#define OP_STITCH_KERNEL 3
+#define OP_IOV_SETUP     4
+#define OP_WRITE_NULL    5
+#define OP_WRITEV_NULL   6
+#define OP_SEND_UNIX     7
+#define OP_SENDMSG_UNIX  8
+#define OP_COUNT         9
+
+const char *micro_op_names[OP_COUNT] = {
+    "fill-malloc", "fill-arena", "stitch-memcpy", "stitch-", "iov-setup",
+    "write-null", "writev-null", "send-unix", "sendmsg-unix"
+};
+micro_op_fn micro_ops[OP_COUNT] = {
+    op_fill_malloc, op_fill_arena, op_stitch_memcpy, op_stitch_kernel, op_iov_setup,
+    op_write_null, op_writev_null, op_send_unix, op_sendmsg_unix
+};
+
+// Reader end of the socketpair: discards everything until EOF.
+void *drain_thread(void *arg) {
+    int fd = *(int *)arg;
+    char *buf = malloc(MICRO_DRAIN_BUF);
+    while (buf && read(fd, buf, MICRO_DRAIN_BUF) > 0) {
+    }
+    free(buf);
+    return NULL;
+}
+
+// ns per message of `op` (after one warmup call), or -1 on error.
+double time_op(micro_cell_t *cell, micro_op_fn op, unsigned long ops, double *ticks) {
+    if (op(cell) != 0) return -1;
+    double t0 = micro_now();
+    uint64_t c0 = micro_ticks();
+    for (unsigned long r = 0; r < ops; r++)
+        if (op(cell) != 0) return -1;
+    uint64_t c1 = micro_ticks();
+    double t1 = micro_now();
+    *ticks = (double)(c1 - c0) / ops;
+    return (t1 - t0) * 1e9 / ops;
+}
+
+int cell_open(micro_cell_t *cell, size_t size, int fields, size_t align) {
+    memset(cell, 0, sizeof(*cell));
+    cell->size = size;
+    cell->fields = fields;
+    cell->align = align;
+    cell->kernel = stitch_kernel_find(NULL);
+    size_t capacity = arena_capacity_for(size, fields, 1, align);
+    if (arena_create(&cell->arena, capacity, align, 0) != 0 ||
+        arena_create(&cell->scratch_arena, capacity, align, 0) != 0 ||
+        fill_complex_message_arena(&cell->msg, size, fields, FIELDS_UNIFORM, &cell->arena) != 0)
+        return -1;
+    cell->stitched = aligned_alloc(64, arena_round_up(size, 64));
+    cell->iov = calloc(IOV_MAX, sizeof(struct iovec));
+    cell->null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    return cell->stitched && cell->iov && cell->null_fd >= 0 ? 0 : -1;
+}
+
+void cell_close(micro_cell_t *cell) {
+    free_complex_message_arena(&cell->msg, &cell->arena);
+    arena_destroy(&cell->arena);
+    arena_destroy(&cell->scratch_arena);
+    free(cell->stitched);
+    free(cell->iov);
+    if (cell->null_fd >= 0) close(cell->null_fd);
+}
+
+int parse_micro_list(char *list, size_t *values) {
+    int n = 0;
+    for (char *tok = strtok(list, ","); tok && n < MICRO_MAX_LIST; tok = strtok(NULL, ",")) {
+        values[n] = strtoull(tok, NULL, 10);
+        if (values[n] == 0) return -1;
+        n++;
+    }
+    return n;
+}
+
+void print_micro_usage(const char *prog) {
+    printf("Usage: %s [-s sizes] [-f fields] [-a aligns] [-b bytes per measurement]\n", prog);
+    printf("  -s L  Message sizes in bytes (default 1024,65536,1048576)\n");
+    printf("  -f L  Fields per message (default 8,64)\n");
+    printf("  -a L  Field alignment in the payload arena (default 1,64,4096)\n");
+    printf("  -b N  Bytes moved per measurement (default %lu)\n", MICRO_DEFAULT_BYTES);
+}
+
+int main(int argc, char *argv[]) {
+    size_t sizes[MICRO_MAX_LIST] = { 1024, 65536, 1048576 }, fields[MICRO_MAX_LIST] = { 8, 64 };
+    size_t aligns[MICRO_MAX_LIST] = { 1, 64, 4096 };
+    int size_count = 3, field_count = 2, align_count = 3;
+    size_t budget = MICRO_DEFAULT_BYTES;
+    int c;
+
+    while ((c = getopt(argc, argv, "s:f:a:b:h")) != -1) {
+        switch (c) {
+        case 's': size_count = parse_micro_list(optarg, sizes); break;
+        case 'f': field_count = parse_micro_list(optarg, fields); break;
+        case 'a': align_count = parse_micro_list(optarg, aligns); break;
+        case 'b': budget = strtoull(optarg, NULL, 10); break;
+        default:
+            print_micro_usage(argv[0]);
+            return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (size_count <= 0 || field_count <= 0 || align_count <= 0 || budget == 0) {
+        print_micro_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (int a = 0; a < align_count; a++)
+        if (aligns[a] & (aligns[a] - 1)) {
+            fprintf(stderr, "Alignment %zu is not a power of two\n", aligns[a]);
+            return EXIT_FAILURE;
+        }
+
+    // The socketpair is shared by all cells; the reader runs on its own thread.
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) {
+        perror("socketpair");
+        return EXIT_FAILURE;
+    }
+    int sndbuf = 4 << 20;
+    setsockopt(pair[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    pthread_t drainer;
+    pthread_create(&drainer, NULL, drain_thread, &pair[1]);
+
+    const stitch_kernel_t *best = stitch_kernel_find(NULL);
+    printf("Stitch kernel: %s; cycles are TSC cycles\n", best->name);
+    printf("%10s %6s %6s  %-14s %12s %9s %9s\n", "Size", "Fields", "Align", "Operation", "ns/op",
+           "GB/s", "B/cycle");
+
+    for (int s = 0; s < size_count; s++)
+        for (int f = 0; f < field_count; f++)
+            for (int a = 0; a < align_count; a++) {
+                micro_cell_t cell;
+                if (fields[f] > sizes[s] || cell_open(&cell, sizes[s], (int)fields[f], aligns[a]) != 0) {
+                    fprintf(stderr, "Skipping %zu bytes in %zu fields, align %zu\n", sizes[s],
+                            fields[f], aligns[a]);
+                    continue;
+                }
+                cell.unix_fd = pair[0];
+                unsigned long ops = budget / sizes[s];
+                if (ops < MICRO_MIN_OPS) ops = MICRO_MIN_OPS;
+                if (ops > MICRO_MAX_OPS) ops = MICRO_MAX_OPS;
+
+                double ns[OP_COUNT];
+                for (int o = 0; o < OP_COUNT; o++) {
+                    char name[32];
+                    ns[o] = -1;
+                    if (o == OP_STITCH_KERNEL && best->copy == stitch_copy_memcpy) continue;
+                    snprintf(name, sizeof(name), "%s%s", micro_op_names[o],
+                             o == OP_STITCH_KERNEL ? best->name : "");
+                    double ticks;
+                    ns[o] = time_op(&cell, micro_ops[o], ops, &ticks);
+                    if (ns[o] < 0) {
+                        fprintf(stderr, "%s failed: %s\n", name, strerror(errno));
+                        continue;
+                    }
+                    printf("%10zu %6zu %6zu  %-14s %12.1f %9.2f %9.3f\n", sizes[s], fields[f],
+                           aligns[a], name, ns[o], sizes[s] / ns[o], sizes[s] / ticks);
+                }
+
+                // 4. Where A1's time per message goes
+                if (ns[OP_STITCH_MEMCPY] >= 0 && ns[OP_WRITE_NULL] >= 0 && ns[OP_SEND_UNIX] >= 0)
+                    printf("%10s %6s %6s  A1 split: user copy %.1f ns, syscall %.1f ns, "
+                           "kernel copy + socket %.1f ns\n", "", "", "", ns[OP_STITCH_MEMCPY],
+                           ns[OP_WRITE_NULL], ns[OP_SEND_UNIX] - ns[OP_WRITE_NULL]);
+                cell_close(&cell);
+            }
+
+    close(pair[0]); // EOF for the reader
+    pthread_join(drainer, NULL);
+    close(pair[1]);
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Roll No: MT25073
+ * File: MT25073_Part_E_StitchBench.c
+ * Part: E (Microbenchmarks)
+ * Description: Compares the A1 stitching kernels (MT25073_Part_A_Stitch.h)
+ * with glibc memcpy on the same ComplexMessage the server stitches.
+ * For every message size and kernel it reports:
+ *   GB/s          : stitched bytes per second
+ *   cycles/B      : TSC cycles per stitched byte
+ *   LLC-miss/KB   : last-level cache misses per KB (perf_event_open; "n/a"
+ *                   if the PMU is not available, e.g. in a VM or with
+ *                   kernel.perf_event_paranoid > 2)
+ * The LLC column is where streaming stores differ: memcpy misses on every
+ * destination line it has to allocate (read-for-ownership), streaming stores
+ * do not allocate at all.
+ *
+ * Usage: ./stitch_bench [-s size,size,...] [-b bytes per measurement] [-f fields]
+ */
+
+#include "MT25073_Part_A_Common.h"
+#include "MT25073_Part_A_Stitch.h"
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define BENCH_DEFAULT_BYTES (1UL << 30) // Stitched per (size, kernel) cell
+#define BENCH_MAX_SIZES 32
+
+size_t bench_default_sizes[] = {
+    4096, 65536, 262144, 1048576, 4194304, 16777216, 67108864,
+};
+
+// --- Time base: the TSC where there is one ---
+uint64_t bench_ticks(void) {
+#ifdef STITCH_X86
+    return __rdtsc();
+#else
+    return run_now_ns();
+#endif
+}
+
+double bench_now(void) {
+    return run_now_ns() / 1e9;
+}
+
+// --- LLC misses of this thread (user space only), -1 if unavailable ---
+int perf_open_llc_misses(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+void perf_start(int fd) {
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+long long perf_stop(int fd) {
+    uint64_t count;
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return (long long)count;
+}
+
+// One stitch, exactly as two_copy_send() does it.
+void stitch_once(char *dst, const ComplexMessage *msg, const stitch_kernel_t *k) {
+    size_t offset = 0;
+    for (int i = 0; i < msg->count; i++) {
+        k->copy(dst + offset, msg->fields[i], msg->sizes[i]);
+        offset += msg->sizes[i];
+    }
+    if (k->non_temporal) stitch_fence();
+}
+
+int parse_sizes(char *list, size_t *sizes) {
+    int n = 0;
+    for (char *tok = strtok(list, ","); tok && n < BENCH_MAX_SIZES; tok = strtok(NULL, ",")) {
+        sizes[n] = strtoull(tok, NULL, 10);
+        if (sizes[n] == 0) return -1;
+        n++;
+    }
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+    size_t sizes[BENCH_MAX_SIZES];
+    int size_count = sizeof(bench_default_sizes) / sizeof(bench_default_sizes[0]);
+    memcpy(sizes, bench_default_sizes, sizeof(bench_default_sizes));
+    size_t budget = BENCH_DEFAULT_BYTES;
+    int fields = MSG_DEFAULT_FIELDS;
+    int c;
+
+    while ((c = getopt(argc, argv, "s:b:f:h")) != -1) {
+        switch (c) {
+        case 's':
+            size_count = parse_sizes(optarg, sizes);
+            if (size_count <= 0) {
+                fprintf(stderr, "Invalid size list\n");
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'b':
+            budget = strtoull(optarg, NULL, 10);
+            break;
+        case 'f':
+            fields = atoi(optarg);
+            break;
+        default:
+            printf("Usage: %s [-s size,size,...] [-b bytes per measurement] [-f fields]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int llc_fd = perf_open_llc_misses();
+    if (llc_fd < 0) perror("perf_event_open (LLC misses not reported)");
+    printf("LLC: %zu bytes, server default -N threshold %zu\n", stitch_llc_size(), stitch_llc_size() / 2);
+    printf("%12s %8s %10s %10s %12s\n", "Size", "Kernel", "GB/s", "cycles/B", "LLC-miss/KB");
+
+    for (int s = 0; s < size_count; s++) {
+        size_t size = sizes[s];
+        ComplexMessage msg;
+        if (fill_complex_message(&msg, size, fields, FIELDS_UNIFORM) != 0) {
+            fprintf(stderr, "Cannot split %zu bytes into %d fields\n", size, fields);
+            return EXIT_FAILURE;
+        }
+        char *dst = aligned_alloc(64, (size + 63) / 64 * 64);
+        if (!dst) {
+            perror("aligned_alloc");
+            return EXIT_FAILURE;
+        }
+        unsigned long reps = budget / size ? budget / size : 1;
+
+        for (int k = 0; k < STITCH_KERNEL_COUNT; k++) {
+            const stitch_kernel_t *kernel = &stitch_kernels[k];
+            if (!stitch_kernel_supported(kernel)) continue;
+
+            // 1. WARM UP: fault the pages in, settle the caches
+            stitch_once(dst, &msg, kernel);
+
+            // 2. MEASURE
+            perf_start(llc_fd);
+            double t0 = bench_now();
+            uint64_t c0 = bench_ticks();
+            for (unsigned long r = 0; r < reps; r++) stitch_once(dst, &msg, kernel);
+            uint64_t c1 = bench_ticks();
+            double t1 = bench_now();
+            long long misses = perf_stop(llc_fd);
+
+            // 3. CHECK: the stitched buffer is field i = 'A' + i, in order
+            if (dst[0] != 'A' || dst[size - 1] != 'A' + (fields - 1) % 26) {
+                fprintf(stderr, "%s produced a wrong buffer\n", kernel->name);
+                return EXIT_FAILURE;
+            }
+
+            double bytes = (double)size * reps;
+            char llc[32];
+            if (misses >= 0) snprintf(llc, sizeof(llc), "%.2f", misses / (bytes / 1024));
+            else snprintf(llc, sizeof(llc), "n/a");
+            printf("%12zu %8s %10.2f %10.3f %12s\n", size, kernel->name,
+                   bytes / (t1 - t0) / 1e9, (double)(c1 - c0) / bytes, llc);
+        }
+        free(dst);
+        free_complex_message(&msg);
+    }
+    if (llc_fd >= 0) close(llc_fd);
+    return 0;
+}